@@ -8,3 +8,7 @@ if(USE_CLANG)
   SET(CMAKE_OBJDUMP       "llvm-objdump")
   SET(CMAKE_RANLIB        "llvm-ranlib")
 endif(USE_CLANG)
+
+option(WIDE_DISTANCE_MATRIX "store the cached distances with 64 instead of 32 bit per entry" OFF)
+
+option(NATIVE_ARCH "compile for the instruction set of the building machine, enables the AVX2 kernels" OFF)
@@ -35,6 +35,11 @@ public:
     auto getLatLng(Node n) const noexcept
         -> std::pair<double, double>;
 
+    // hash of the offset arrays, used to identify data which was
+    // precomputed for exactly this graph. It is computed once with the graph
+    auto fingerprint() const noexcept
+        -> std::uint64_t;
+
 private:
     std::vector<std::pair<Node, Distance>> forward_neigbours_;
     std::vector<size_t> forward_offset_;
@@ -44,6 +49,8 @@ private:
 
     std::vector<double> lats_;
     std::vector<double> lngs_;
+
+    std::uint64_t fingerprint_;
 };
 
 auto parseFMIFile(std::string_view path) noexcept
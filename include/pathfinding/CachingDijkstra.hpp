@@ -1,11 +1,11 @@
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <optional>
-#include <pathfinding/DijkstraQueue.hpp>
 #include <pathfinding/Distance.hpp>
+#include <pathfinding/DistanceMatrix.hpp>
 #include <pathfinding/Path.hpp>
-#include <queue>
 #include <string_view>
 #include <vector>
 
@@ -18,10 +18,19 @@ namespace pathfinding {
 class CachingDijkstra
 {
 public:
-    CachingDijkstra(const graph::Graph &graph) noexcept;
+    // if a cache folder is given, the distances are loaded from a matrix which
+    // was computed for the same graph in an earlier run or stored for later runs.
+    // A transposed copy doubles the memory but makes the columns contiguous.
+    // Recorded predecessors let findRoute walk a path without any lookups
+    // of the backward neighbours. The distances of the graph have to fit
+    // into the matrix entries, see DistanceMatrix::canHoldDistancesOf
+    CachingDijkstra(const graph::Graph &graph,
+                    std::optional<std::string_view> cache_folder = std::nullopt,
+                    bool transposed_copy = false,
+                    bool record_predecessors = false) noexcept;
     CachingDijkstra() = delete;
     CachingDijkstra(CachingDijkstra &&) = default;
-    CachingDijkstra(const CachingDijkstra &) = default;
+    CachingDijkstra(const CachingDijkstra &) = delete;
     auto operator=(const CachingDijkstra &) -> CachingDijkstra & = delete;
     auto operator=(CachingDijkstra &&) -> CachingDijkstra & = delete;
 
@@ -29,45 +38,38 @@ public:
                                     graph::Node target) const noexcept
         -> graph::Distance;
 
+    // shortest path read from the cached distances, no search is run
+    [[nodiscard]] auto findRoute(graph::Node source,
+                                 graph::Node target) const noexcept
+        -> std::optional<Path>;
 
-    auto destroy() noexcept -> void;
-
-
-private:
-    [[nodiscard]] auto getDistanceTo(graph::Node n) const noexcept
-        -> graph::Distance;
+    // the node before the target in the shortest path tree of the source,
+    // nothing if the predecessors are not kept
+    [[nodiscard]] auto findPredecessor(graph::Node source,
+                                       graph::Node target) const noexcept
+        -> std::optional<graph::Node>;
 
-    auto setDistanceTo(graph::Node n, std::int64_t distance) noexcept
-        -> void;
+    [[nodiscard]] auto hasPredecessors() const noexcept
+        -> bool;
 
-    [[nodiscard]] auto computeDistance(graph::Node source,
-                                       graph::Node target) noexcept
-        -> graph::Distance;
-
-    auto unSettle(graph::Node n) noexcept -> void;
-
-    auto settle(graph::Node n) noexcept -> void;
+    // distances from the source to all nodes
+    [[nodiscard]] auto row(graph::Node source) const noexcept
+        -> DistanceSlice;
 
-    [[nodiscard]] auto isSettled(graph::Node n) noexcept -> bool;
+    // distances from all nodes to the target
+    [[nodiscard]] auto column(graph::Node target) const noexcept
+        -> DistanceSlice;
 
-    auto reset() noexcept -> void;
-
-    [[nodiscard]] auto betweenness(graph::Node n) noexcept
-        -> std::size_t;
+    auto destroy() noexcept -> void;
 
-    auto insertCache(graph::Node source, graph::Node target, graph::Distance dist) noexcept
-        -> void;
 
 private:
     const graph::Graph &graph_;
-    std::vector<graph::Distance> distances_;
-    std::vector<bool> settled_;
-    std::vector<graph::Node> touched_;
-    DijkstraQueue pq_;
-    std::optional<graph::Node> last_source_;
 
-    using DistanceCache = std::vector<std::vector<graph::Distance>>;
-    DistanceCache distance_cache_;
+    //last node before the target on the path from the source, row-major
+    std::vector<std::uint32_t> predecessors_;
+    DistanceMatrix distance_cache_;
+    std::optional<DistanceMatrix> transposed_cache_;
 };
 
 } // namespace pathfinding
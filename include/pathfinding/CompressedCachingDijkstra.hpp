@@ -0,0 +1,36 @@
+#pragma once
+
+#include <pathfinding/CompressedDistanceMatrix.hpp>
+#include <pathfinding/Distance.hpp>
+
+namespace graph {
+class Graph;
+}
+
+namespace pathfinding {
+
+// distance oracle like the CachingDijkstra, but the all to all distances are
+// held in a CompressedDistanceMatrix, trading some lookup time for memory
+class CompressedCachingDijkstra
+{
+public:
+    CompressedCachingDijkstra(const graph::Graph &graph) noexcept;
+    CompressedCachingDijkstra() = delete;
+    CompressedCachingDijkstra(CompressedCachingDijkstra &&) = default;
+    CompressedCachingDijkstra(const CompressedCachingDijkstra &) = delete;
+    auto operator=(const CompressedCachingDijkstra &) -> CompressedCachingDijkstra & = delete;
+    auto operator=(CompressedCachingDijkstra &&) -> CompressedCachingDijkstra & = delete;
+
+    [[nodiscard]] auto findDistance(graph::Node source,
+                                    graph::Node target) const noexcept
+        -> graph::Distance;
+
+    auto destroy() noexcept -> void;
+
+private:
+    const graph::Graph &graph_;
+
+    CompressedDistanceMatrix distance_cache_;
+};
+
+} // namespace pathfinding
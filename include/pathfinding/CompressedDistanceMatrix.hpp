@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <graph/Graph.hpp>
+#include <pathfinding/Distance.hpp>
+#include <vector>
+
+namespace pathfinding {
+
+// lossless compressed n x n distance matrix with random access.
+// A small set of rows is chosen as landmarks, every other row is stored as
+// the difference to the landmark row which is closest to it, which keeps the
+// differences within d(s, l) + d(l, s). The (difference) rows are split into
+// blocks of BLOCK_SIZE entries, each block stores its minimum as frame of
+// reference and the remaining values bit-packed with the width of its range.
+class CompressedDistanceMatrix
+{
+public:
+    static constexpr auto BLOCK_SIZE = std::size_t{64};
+
+    // one landmark is chosen for every LANDMARK_RATIO nodes
+    static constexpr auto LANDMARK_RATIO = std::size_t{64};
+
+    CompressedDistanceMatrix(const graph::Graph& graph) noexcept;
+    CompressedDistanceMatrix() = delete;
+    CompressedDistanceMatrix(CompressedDistanceMatrix&&) = default;
+    CompressedDistanceMatrix(const CompressedDistanceMatrix&) = delete;
+    auto operator=(const CompressedDistanceMatrix&) -> CompressedDistanceMatrix& = delete;
+    auto operator=(CompressedDistanceMatrix&&) -> CompressedDistanceMatrix& = default;
+
+    [[nodiscard]] auto get(graph::Node source,
+                           graph::Node target) const noexcept
+        -> graph::Distance;
+
+    [[nodiscard]] auto size() const noexcept
+        -> std::size_t;
+
+    // number of bytes used by the compressed representation
+    [[nodiscard]] auto memoryUsage() const noexcept
+        -> std::size_t;
+
+    auto destroy() noexcept
+        -> void;
+
+private:
+    [[nodiscard]] auto decode(graph::Node row,
+                              graph::Node column) const noexcept
+        -> std::int64_t;
+
+    auto encodeRow(graph::Node row,
+                   const std::vector<std::int64_t>& values) noexcept
+        -> std::vector<std::uint64_t>;
+
+private:
+    std::size_t number_of_nodes_;
+    std::size_t blocks_per_row_;
+
+    // the row every row is stored relative to, landmarks reference themselves
+    std::vector<std::uint32_t> reference_;
+
+    std::vector<std::uint64_t> row_offset_;
+    std::vector<std::uint32_t> block_offset_;
+    std::vector<std::int64_t> block_base_;
+    std::vector<std::uint8_t> block_width_;
+
+    std::vector<std::uint64_t> packed_;
+};
+
+} // namespace pathfinding
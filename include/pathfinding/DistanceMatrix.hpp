@@ -0,0 +1,164 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <graph/Graph.hpp>
+#include <limits>
+#include <memory>
+#include <nonstd/span.hpp>
+#include <optional>
+#include <pathfinding/Distance.hpp>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace pathfinding {
+
+#ifdef WIDE_DISTANCE_MATRIX
+using MatrixEntry = std::uint64_t;
+#else
+using MatrixEntry = std::uint32_t;
+#endif
+
+// nodes together with a distance each, like the patches of a selection
+using NodeDistances = nonstd::span<const std::pair<graph::Node, graph::Distance>>;
+
+// distances of one row or one column of a matrix, a column of a row-major
+// matrix is read with the row stride of the matrix
+class DistanceSlice
+{
+public:
+    DistanceSlice(const MatrixEntry* entries, std::size_t stride) noexcept
+        : entries_(entries),
+          stride_(stride) {}
+
+    [[nodiscard]] auto operator[](graph::Node n) const noexcept
+        -> graph::Distance;
+
+    [[nodiscard]] auto isContiguous() const noexcept
+        -> bool
+    {
+        return stride_ == 1;
+    }
+
+    // true if the slice holds offset + d for every node n with distance d.
+    // With AVX2 four entries are gathered and compared at once
+    [[nodiscard]] auto matchesAll(graph::Distance offset,
+                                  NodeDistances nodes) const noexcept
+        -> bool;
+
+    // true if the slice holds offset + other[n] for every node n, nodes which
+    // are unreachable in the other slice never match
+    [[nodiscard]] auto matchesAll(graph::Distance offset,
+                                  const DistanceSlice& other,
+                                  NodeDistances nodes) const noexcept
+        -> bool;
+
+private:
+    const MatrixEntry* entries_;
+    std::size_t stride_;
+};
+
+// n x n distances stored row-major in one cache line aligned allocation,
+// every row starts at a cache line as well. UNREACHABLE is stored as the
+// largest value of the entry type
+class DistanceMatrix
+{
+public:
+    static constexpr auto ALIGNMENT = std::size_t{64};
+    static constexpr auto UNREACHABLE_ENTRY = std::numeric_limits<MatrixEntry>::max();
+    //a wide entry holds more than a distance, the limit is the smaller one of both
+    static constexpr auto MAX_DISTANCE = static_cast<graph::Distance>(
+        std::min<std::uint64_t>(UNREACHABLE_ENTRY - 1,
+                                std::numeric_limits<graph::Distance>::max() - 1));
+
+    DistanceMatrix(std::size_t number_of_nodes) noexcept;
+    DistanceMatrix() = delete;
+    DistanceMatrix(DistanceMatrix&&) = default;
+    DistanceMatrix(const DistanceMatrix&) = delete;
+    auto operator=(const DistanceMatrix&) -> DistanceMatrix& = delete;
+    auto operator=(DistanceMatrix&&) -> DistanceMatrix& = default;
+
+    [[nodiscard]] auto get(graph::Node source,
+                           graph::Node target) const noexcept
+        -> graph::Distance;
+
+    // the entries of the row of the source, including the padding
+    [[nodiscard]] auto row(graph::Node source) const noexcept
+        -> nonstd::span<const MatrixEntry>;
+
+    // the column of the target, read with the row stride
+    [[nodiscard]] auto column(graph::Node target) const noexcept
+        -> DistanceSlice;
+
+    // copy of the matrix with rows and columns swapped, such that the
+    // columns of this matrix can be read contiguously from the copy
+    [[nodiscard]] auto transposed() const noexcept
+        -> DistanceMatrix;
+
+    [[nodiscard]] static auto toDistance(MatrixEntry entry) noexcept
+        -> graph::Distance
+    {
+        if(entry == UNREACHABLE_ENTRY) {
+            return graph::UNREACHABLE;
+        }
+
+        return static_cast<graph::Distance>(entry);
+    }
+
+    // writes the row of the source, the distances have to fit
+    // into the entries, see canHoldDistancesOf
+    auto setRow(graph::Node source,
+                const std::vector<graph::Distance>& distances) noexcept
+        -> void;
+
+    // true if every shortest path distance of the graph fits into an entry.
+    // A shortest path leaves every node at most once, such that the heaviest
+    // outgoing edges of all nodes together bound its length
+    [[nodiscard]] static auto canHoldDistancesOf(const graph::Graph& graph) noexcept
+        -> bool;
+
+    [[nodiscard]] auto size() const noexcept
+        -> std::size_t;
+
+    auto destroy() noexcept
+        -> void;
+
+    // writes the matrix into a binary file tagged with the fingerprint
+    // of the graph it was computed for
+    auto toFile(std::string_view path, std::uint64_t fingerprint) const noexcept
+        -> bool;
+
+    // maps a file written by toFile read-only into memory, pages are only
+    // loaded from disk when the rows are accessed
+    [[nodiscard]] static auto fromFile(std::string_view path,
+                                       std::uint64_t fingerprint,
+                                       std::size_t number_of_nodes) noexcept
+        -> std::optional<DistanceMatrix>;
+
+private:
+    DistanceMatrix(std::size_t number_of_nodes,
+                   MatrixEntry* entries,
+                   std::size_t mapped_bytes) noexcept;
+
+    // releases either an aligned allocation or a mapped file
+    struct EntryDelete
+    {
+        std::size_t mapped_bytes = 0;
+
+        auto operator()(MatrixEntry* entries) const noexcept
+            -> void;
+    };
+
+    std::size_t number_of_nodes_;
+    std::size_t row_stride_;
+    std::unique_ptr<MatrixEntry[], EntryDelete> entries_;
+};
+
+inline auto DistanceSlice::operator[](graph::Node n) const noexcept
+    -> graph::Distance
+{
+    return DistanceMatrix::toDistance(entries_[n * stride_]);
+}
+
+} // namespace pathfinding
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <graph/Graph.hpp>
+#include <optional>
+#include <pathfinding/DijkstraQueue.hpp>
+#include <pathfinding/Distance.hpp>
+#include <vector>
+
+namespace pathfinding {
+
+// dijkstra search which is advanced by the caller one settled node at a time,
+// such that the nodes around the source are visited in increasing distance and
+// the search can be stopped as soon as the caller has seen enough of them
+class IncrementalDijkstra
+{
+public:
+    enum class Direction {
+        // distances from the source to the settled nodes
+        FORWARD,
+        // distances from the settled nodes to the source
+        BACKWARD
+    };
+
+    IncrementalDijkstra(const graph::Graph& graph, Direction direction) noexcept;
+    IncrementalDijkstra() = delete;
+    IncrementalDijkstra(IncrementalDijkstra&&) = default;
+    IncrementalDijkstra(const IncrementalDijkstra&) = default;
+    auto operator=(const IncrementalDijkstra&) -> IncrementalDijkstra& = delete;
+    auto operator=(IncrementalDijkstra&&) -> IncrementalDijkstra& = delete;
+
+    // resets the search and starts it at the given source
+    auto start(graph::Node source) noexcept
+        -> void;
+
+    // settles the next closest node, nothing if all reachable nodes are settled
+    [[nodiscard]] auto settleNext() noexcept
+        -> std::optional<std::pair<graph::Node, graph::Distance>>;
+
+private:
+    auto reset() noexcept
+        -> void;
+
+private:
+    const graph::Graph& graph_;
+    Direction direction_;
+    std::vector<graph::Distance> distances_;
+    std::vector<bool> settled_;
+    std::vector<graph::Node> touched_;
+    DijkstraQueue pq_;
+};
+
+} // namespace pathfinding
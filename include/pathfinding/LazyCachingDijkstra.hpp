@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <pathfinding/Distance.hpp>
+#include <pathfinding/DistanceMatrix.hpp>
+#include <pathfinding/OneToAllDijkstra.hpp>
+#include <tbb/enumerable_thread_specific.h>
+#include <vector>
+
+namespace graph {
+class Graph;
+}
+
+namespace pathfinding {
+
+// distance oracle which computes the row of a source with a one to all search
+// the first time it is used and keeps as many rows as fit into the memory
+// budget. If the budget is exhausted, rows are evicted in CLOCK order.
+// Lookups of cached rows take no lock, every slot is guarded by a sequence
+// counter which is odd while the slot is rewritten. The distances of the graph
+// have to fit into the entries, see DistanceMatrix::canHoldDistancesOf
+class LazyCachingDijkstra
+{
+public:
+    LazyCachingDijkstra(const graph::Graph &graph,
+                        std::size_t memory_budget) noexcept;
+    LazyCachingDijkstra() = delete;
+    LazyCachingDijkstra(LazyCachingDijkstra &&) = delete;
+    LazyCachingDijkstra(const LazyCachingDijkstra &) = delete;
+    auto operator=(const LazyCachingDijkstra &) -> LazyCachingDijkstra & = delete;
+    auto operator=(LazyCachingDijkstra &&) -> LazyCachingDijkstra & = delete;
+
+    [[nodiscard]] auto findDistance(graph::Node source,
+                                    graph::Node target) const noexcept
+        -> graph::Distance;
+
+    [[nodiscard]] auto numberOfSlots() const noexcept
+        -> std::size_t;
+
+    // number of rows which had to be computed so far
+    [[nodiscard]] auto numberOfMisses() const noexcept
+        -> std::size_t;
+
+    auto destroy() noexcept -> void;
+
+private:
+    struct Slot
+    {
+        std::atomic<std::uint64_t> sequence{0};
+        std::atomic<std::uint32_t> owner;
+        std::atomic_bool referenced{false};
+    };
+
+    [[nodiscard]] auto tryCachedDistance(graph::Node source,
+                                         graph::Node target) const noexcept
+        -> std::optional<graph::Distance>;
+
+    auto insertRow(graph::Node source,
+                   const std::vector<graph::Distance> &distances) const noexcept
+        -> void;
+
+    // advances the clock hand until a slot without reference bit is found
+    [[nodiscard]] auto findVictim() const noexcept
+        -> std::size_t;
+
+private:
+    const graph::Graph &graph_;
+    std::size_t number_of_nodes_;
+    std::size_t number_of_slots_;
+
+    //the cache is filled on lookups, which are const for the callers
+    mutable std::unique_ptr<Slot[]> slots_;
+    mutable std::unique_ptr<std::atomic<MatrixEntry>[]> entries_;
+    mutable std::unique_ptr<std::atomic<std::uint32_t>[]> slot_of_;
+
+    mutable std::mutex eviction_mutex_;
+    mutable std::size_t clock_hand_ = 0;
+    mutable std::atomic_size_t misses_ = 0;
+
+    using SearchSpaces = tbb::enumerable_thread_specific<OneToAllDijkstra>;
+    mutable std::unique_ptr<SearchSpaces> searches_;
+};
+
+} // namespace pathfinding
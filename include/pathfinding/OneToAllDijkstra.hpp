@@ -0,0 +1,48 @@
+#pragma once
+
+#include <graph/Graph.hpp>
+#include <pathfinding/DijkstraQueue.hpp>
+#include <pathfinding/Distance.hpp>
+#include <vector>
+
+namespace pathfinding {
+
+class OneToAllDijkstra
+{
+public:
+    OneToAllDijkstra(const graph::Graph& graph) noexcept;
+    OneToAllDijkstra() = delete;
+    OneToAllDijkstra(OneToAllDijkstra&&) = default;
+    OneToAllDijkstra(const OneToAllDijkstra&) = default;
+    auto operator=(const OneToAllDijkstra&) -> OneToAllDijkstra& = delete;
+    auto operator=(OneToAllDijkstra&&) -> OneToAllDijkstra& = delete;
+
+    // runs a complete search from the source and returns the distances to
+    // all nodes, the returned reference is valid until the next search
+    [[nodiscard]] auto computeDistancesFrom(graph::Node source) noexcept
+        -> const std::vector<graph::Distance>&;
+
+    // the node before every node on its shortest path from the source of the
+    // last search, NOT_REACHABLE for the source itself and unreachable nodes
+    [[nodiscard]] auto getPredecessors() const noexcept
+        -> const std::vector<graph::Node>&;
+
+private:
+    [[nodiscard]] auto getDistanceTo(graph::Node n) const noexcept
+        -> graph::Distance;
+
+    auto setDistanceTo(graph::Node n, graph::Distance distance) noexcept
+        -> void;
+
+    auto reset() noexcept
+        -> void;
+
+private:
+    const graph::Graph& graph_;
+    std::vector<graph::Distance> distances_;
+    std::vector<graph::Node> predecessors_;
+    std::vector<graph::Node> touched_;
+    DijkstraQueue pq_;
+};
+
+} // namespace pathfinding
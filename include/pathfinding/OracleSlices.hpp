@@ -0,0 +1,151 @@
+#pragma once
+
+#include <pathfinding/Distance.hpp>
+#include <pathfinding/DistanceMatrix.hpp>
+#include <type_traits>
+#include <utility>
+
+namespace pathfinding {
+
+// oracles which hold a full matrix expose row(n) and column(n), which read
+// many distances from or to the same node without a lookup per distance
+template<class DistanceOracle, class = void>
+struct has_slices : std::false_type
+{
+};
+
+template<class DistanceOracle>
+struct has_slices<DistanceOracle,
+                  std::void_t<decltype(std::declval<const DistanceOracle&>().row(graph::Node{})),
+                              decltype(std::declval<const DistanceOracle&>().column(graph::Node{}))>>
+    : std::true_type
+{
+};
+
+template<class DistanceOracle>
+constexpr auto has_slices_v = has_slices<DistanceOracle>::value;
+
+// fallback for all other oracles, forwards every access to findDistance
+template<class DistanceOracle, bool IsRow>
+class OracleSlice
+{
+public:
+    OracleSlice(const DistanceOracle& oracle, graph::Node node) noexcept
+        : oracle_(oracle),
+          node_(node) {}
+
+    [[nodiscard]] auto operator[](graph::Node n) const noexcept
+        -> graph::Distance
+    {
+        if constexpr(IsRow) {
+            return oracle_.findDistance(node_, n);
+        } else {
+            return oracle_.findDistance(n, node_);
+        }
+    }
+
+    // every distance is a lookup of its own
+    [[nodiscard]] auto isContiguous() const noexcept
+        -> bool
+    {
+        return false;
+    }
+
+    [[nodiscard]] auto matchesAll(graph::Distance offset,
+                                  NodeDistances nodes) const noexcept
+        -> bool
+    {
+        for(auto [n, distance] : nodes) {
+            if((*this)[n] != offset + distance) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    [[nodiscard]] auto matchesAll(graph::Distance offset,
+                                  const OracleSlice& other,
+                                  NodeDistances nodes) const noexcept
+        -> bool
+    {
+        for(auto [n, _] : nodes) {
+            const auto other_distance = other[n];
+            if(other_distance == graph::UNREACHABLE or (*this)[n] != offset + other_distance) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    const DistanceOracle& oracle_;
+    graph::Node node_;
+};
+
+// distances from the source to every node, accessed with operator[]
+template<class DistanceOracle>
+[[nodiscard]] auto distancesFrom(const DistanceOracle& oracle,
+                                 graph::Node source) noexcept
+{
+    if constexpr(has_slices_v<DistanceOracle>) {
+        return oracle.row(source);
+    } else {
+        return OracleSlice<DistanceOracle, true>{oracle, source};
+    }
+}
+
+// distances from every node to the target, accessed with operator[]
+template<class DistanceOracle>
+[[nodiscard]] auto distancesTo(const DistanceOracle& oracle,
+                               graph::Node target) noexcept
+{
+    if constexpr(has_slices_v<DistanceOracle>) {
+        return oracle.column(target);
+    } else {
+        return OracleSlice<DistanceOracle, false>{oracle, target};
+    }
+}
+
+// true if the center is on a shortest path from the source to every target,
+// that is d(source, center) + d(center, t) = d(source, t) for all targets t
+template<class DistanceOracle>
+[[nodiscard]] auto centerOnPathsFrom(const DistanceOracle& oracle,
+                                     graph::Node source,
+                                     graph::Node center,
+                                     NodeDistances targets) noexcept
+    -> bool
+{
+    const auto from_source = distancesFrom(oracle, source);
+    const auto source_center = from_source[center];
+
+    if(source_center == graph::UNREACHABLE) {
+        return false;
+    }
+
+    return from_source.matchesAll(source_center,
+                                  distancesFrom(oracle, center),
+                                  targets);
+}
+
+// true if the center is on a shortest path from every source to the target,
+// that is d(s, center) + d(center, target) = d(s, target) for all sources s
+template<class DistanceOracle>
+[[nodiscard]] auto centerOnPathsTo(const DistanceOracle& oracle,
+                                   graph::Node target,
+                                   graph::Node center,
+                                   NodeDistances sources) noexcept
+    -> bool
+{
+    const auto to_target = distancesTo(oracle, target);
+    const auto center_target = to_target[center];
+
+    if(center_target == graph::UNREACHABLE) {
+        return false;
+    }
+
+    return to_target.matchesAll(center_target,
+                                distancesTo(oracle, center),
+                                sources);
+}
+
+} // namespace pathfinding
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <deque>
+#include <graph/Graph.hpp>
+#include <optional>
+#include <pathfinding/Distance.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace pathfinding {
+
+// a backward neighbour of the node on a shortest path from the source
+// which is strictly closer to the source than the node itself
+template<class Slice>
+[[nodiscard]] auto findCloserPredecessor(const graph::Graph& graph,
+                                         graph::Node node,
+                                         const Slice& from_source) noexcept
+    -> std::optional<graph::Node>
+{
+    const auto node_distance = from_source[node];
+
+    for(auto [neig, distance] : graph.getBackwardNeigboursOf(node)) {
+        const auto neig_distance = from_source[neig];
+
+        if(neig_distance != graph::UNREACHABLE
+           and neig_distance < node_distance
+           and neig_distance + distance == node_distance) {
+            return neig;
+        }
+    }
+
+    return std::nullopt;
+}
+
+// the nodes on the fewest zero weight edges back from the node to the source
+// or to a node which has a strictly closer predecessor, the node itself is
+// excluded. A breadth first search visits every node once, such that zero
+// weight cycles are left. Empty if no such node is reachable
+template<class Slice>
+[[nodiscard]] auto findZeroWeightExit(const graph::Graph& graph,
+                                      graph::Node from,
+                                      graph::Node node,
+                                      const Slice& from_source) noexcept
+    -> std::vector<graph::Node>
+{
+    const auto node_distance = from_source[node];
+
+    //the node after every visited node on the way back to the start
+    std::unordered_map<graph::Node, graph::Node> after{{node, node}};
+    std::deque<graph::Node> queue{node};
+
+    while(!queue.empty()) {
+        const auto current = queue.front();
+        queue.pop_front();
+
+        if(current != node
+           and (current == from or findCloserPredecessor(graph, current, from_source))) {
+            std::vector<graph::Node> nodes;
+            for(auto n = current; n != node; n = after[n]) {
+                nodes.emplace_back(n);
+            }
+            return std::vector<graph::Node>(std::rbegin(nodes), std::rend(nodes));
+        }
+
+        for(auto [neig, distance] : graph.getBackwardNeigboursOf(current)) {
+            if(distance == 0
+               and from_source[neig] == node_distance
+               and after.emplace(neig, current).second) {
+                queue.emplace_back(neig);
+            }
+        }
+    }
+
+    return {};
+}
+
+// walks a shortest path from the target back to the source with the distances
+// from the source alone, no search is run. The node before a node is a strictly
+// closer backward neighbour u with d(s, u) + w(u, c) = d(s, c). A node without
+// one lies behind zero weight edges and the walk continues over the fewest of
+// them, such that every step either gets closer to the source or leaves the
+// zero weight edges at a node which was not visited before. The visitor is
+// called for every node before the target, down to and including the source,
+// until it returns false. Returns false if the distances do not describe a
+// path through the graph
+template<class Slice, class Visitor>
+[[nodiscard]] auto walkPathBackwards(const graph::Graph& graph,
+                                     graph::Node from,
+                                     graph::Node to,
+                                     const Slice& from_source,
+                                     Visitor&& visit) noexcept
+    -> bool
+{
+    if(from_source[to] == graph::UNREACHABLE) {
+        return false;
+    }
+
+    auto current = to;
+    while(current != from) {
+        if(auto closer = findCloserPredecessor(graph, current, from_source)) {
+            current = closer.value();
+            if(!visit(current)) {
+                return true;
+            }
+            continue;
+        }
+
+        const auto exit = findZeroWeightExit(graph, from, current, from_source);
+        if(exit.empty()) {
+            return false;
+        }
+
+        for(auto node : exit) {
+            current = node;
+            if(!visit(current)) {
+                return true;
+            }
+        }
+    }
+
+    return true;
+}
+
+} // namespace pathfinding
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>
+#include <graph/Graph.hpp>
+#include <nonstd/span.hpp>
+#include <numeric>
+#include <optional>
+#include <pathfinding/Distance.hpp>
+#include <pathfinding/Path.hpp>
+#include <vector>
+
+namespace pathfinding {
+
+using Query = std::pair<graph::Node, graph::Node>;
+
+// runs a batch of queries grouped by their source, such that a path finder
+// which resumes its last search (like Dijkstra) only starts one search per
+// source. Inside of a group the order of the targets does not change the
+// number of settled nodes, because the resumed search only ever runs until the
+// farthest target of the group is settled and every other target is answered
+// from the already settled nodes, therefore the groups are kept stable.
+// The results are returned in the order of the given queries.
+template<class PathFinder>
+class QueryScheduler
+{
+public:
+    QueryScheduler(PathFinder& path_finder)
+        : path_finder_(path_finder) {}
+
+    [[nodiscard]] auto findDistances(nonstd::span<const Query> queries) noexcept
+        -> std::vector<graph::Distance>
+    {
+        return run<graph::Distance>(
+            queries,
+            [&](auto source, auto target) {
+                return path_finder_.findDistance(source, target);
+            });
+    }
+
+    [[nodiscard]] auto findRoutes(nonstd::span<const Query> queries) noexcept
+        -> std::vector<std::optional<Path>>
+    {
+        return run<std::optional<Path>>(
+            queries,
+            [&](auto source, auto target) {
+                return path_finder_.findRoute(source, target);
+            });
+    }
+
+    [[nodiscard]] auto calculateDijkstraRanks(nonstd::span<const Query> queries) noexcept
+        -> std::vector<std::size_t>
+    {
+        return run<std::size_t>(
+            queries,
+            [&](auto source, auto target) {
+                return path_finder_.calculateDijkstraRank(source, target);
+            });
+    }
+
+    template<class Result, class F>
+    [[nodiscard]] auto run(nonstd::span<const Query> queries, F&& func) noexcept
+        -> std::vector<Result>
+    {
+        std::vector<Result> results(queries.size());
+
+        for(auto idx : groupBySource(queries)) {
+            auto [source, target] = queries[idx];
+            results[idx] = func(source, target);
+        }
+
+        return results;
+    }
+
+private:
+    // stable counting sort of the query indices by the source of the query
+    [[nodiscard]] static auto groupBySource(nonstd::span<const Query> queries) noexcept
+        -> std::vector<std::size_t>
+    {
+        if(queries.empty()) {
+            return {};
+        }
+
+        auto max_source = std::max_element(
+                              std::begin(queries),
+                              std::end(queries),
+                              [](auto lhs, auto rhs) {
+                                  return lhs.first < rhs.first;
+                              })
+                              ->first;
+
+        std::vector<std::size_t> offsets(max_source + 2, 0);
+        for(auto [source, _] : queries) {
+            offsets[source + 1]++;
+        }
+
+        std::partial_sum(std::begin(offsets),
+                         std::end(offsets),
+                         std::begin(offsets));
+
+        std::vector<std::size_t> order(queries.size());
+        for(std::size_t i = 0; i < queries.size(); i++) {
+            order[offsets[queries[i].first]++] = i;
+        }
+
+        return order;
+    }
+
+private:
+    PathFinder& path_finder_;
+};
+
+} // namespace pathfinding
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <graph/Graph.hpp>
+#include <optional>
+#include <pathfinding/Distance.hpp>
+#include <pathfinding/OracleSlices.hpp>
+#include <selection/NodeSelection.hpp>
+#include <vector>
+
+namespace selection {
+
+// keeps the candidates of one patch which are still consistent with every
+// member of the other patch, i.e. whose shortest paths to (or from) all of
+// these members run through the center. The patches only grow, so a candidate
+// which fails once can never pass again. Adding a member therefore checks only
+// the surviving candidates and only against this one member, reading a single
+// row or column of the oracle, and the check of a candidate is a lookup.
+// IsSource is true for the filter of the source candidates, its members are
+// the targets of the selection
+template<class DistanceOracle, bool IsSource>
+class AffiliationFilter
+{
+public:
+    AffiliationFilter(const DistanceOracle& distance_oracle,
+                      std::size_t number_of_nodes) noexcept
+        : distance_oracle_(distance_oracle),
+          center_distances_(number_of_nodes, graph::UNREACHABLE),
+          alive_(number_of_nodes, false),
+          contiguous_(number_of_nodes > 0 and memberSlice(0).isContiguous()) {}
+
+    // filtering pays off only if the slices are read contiguously, strided
+    // columns or single lookups are slower than checking every candidate
+    // against its own row
+    [[nodiscard]] auto isContiguous() const noexcept
+        -> bool
+    {
+        return contiguous_;
+    }
+
+    // starts a new selection, every candidate which reaches the center (or is
+    // reached from it) and is consistent with the given members survives
+    template<class IsCandidate>
+    auto reset(graph::Node center,
+               const Patch& members,
+               IsCandidate&& is_candidate) noexcept
+        -> void
+    {
+        for(auto n : survivors_) {
+            alive_[n] = false;
+        }
+        survivors_.clear();
+
+        const auto center_slice = centerSlice(center);
+        for(graph::Node n = 0; n < alive_.size(); n++) {
+            const auto distance = center_slice[n];
+            center_distances_[n] = distance;
+
+            if(distance != graph::UNREACHABLE and is_candidate(n)) {
+                alive_[n] = true;
+                survivors_.emplace_back(n);
+            }
+        }
+
+        for(auto [member, center_member_distance] : members) {
+            add(member, center_member_distance);
+        }
+    }
+
+    // a new member with its distance to (or from) the center was added
+    // to the other patch, drops all candidates which are not consistent
+    auto add(graph::Node member, graph::Distance center_member_distance) noexcept
+        -> void
+    {
+        const auto member_slice = memberSlice(member);
+
+        auto kept = std::begin(survivors_);
+        for(auto n : survivors_) {
+            if(center_distances_[n] + center_member_distance == member_slice[n]) {
+                *kept++ = n;
+            } else {
+                alive_[n] = false;
+            }
+        }
+
+        survivors_.erase(kept, std::end(survivors_));
+    }
+
+    // distance between the candidate and the center if the candidate is
+    // consistent with all members, nothing otherwise
+    [[nodiscard]] auto affiliation(graph::Node candidate) const noexcept
+        -> std::optional<graph::Distance>
+    {
+        if(!alive_[candidate]) {
+            return std::nullopt;
+        }
+
+        return center_distances_[candidate];
+    }
+
+private:
+    // distances of all nodes to the center for sources, from it for targets
+    [[nodiscard]] auto centerSlice(graph::Node center) const noexcept
+    {
+        if constexpr(IsSource) {
+            return pathfinding::distancesTo(distance_oracle_, center);
+        } else {
+            return pathfinding::distancesFrom(distance_oracle_, center);
+        }
+    }
+
+    // distances of all nodes to a target member, or from a source member
+    [[nodiscard]] auto memberSlice(graph::Node member) const noexcept
+    {
+        if constexpr(IsSource) {
+            return pathfinding::distancesTo(distance_oracle_, member);
+        } else {
+            return pathfinding::distancesFrom(distance_oracle_, member);
+        }
+    }
+
+private:
+    const DistanceOracle& distance_oracle_;
+    std::vector<graph::Distance> center_distances_;
+    std::vector<bool> alive_;
+    std::vector<graph::Node> survivors_;
+    bool contiguous_;
+};
+
+} // namespace selection
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <algorithm>
+#include <fmt/core.h>
+#include <graph/Graph.hpp>
+#include <mutex>
+#include <optional>
+#include <pathfinding/DijkstraQueue.hpp>
+#include <pathfinding/Distance.hpp>
+#include <pathfinding/Path.hpp>
+#include <progresscpp/ProgressBar.hpp>
+#include <random>
+#include <selection/NodeSelection.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <utils/Range.hpp>
+#include <vector>
+
+namespace selection {
+
+// chooses the node with the highest betweenness centrality on the path as
+// center. The betweenness is computed with Brandes' algorithm, one search per
+// source in parallel, each thread accumulating into its own vector. If a
+// number of samples is given, only that many sources are searched and the
+// result is scaled by n / samples, which approximates the betweenness
+template<class PathFinder>
+class BetweennessCenterCalculator
+{
+public:
+    static constexpr auto DEFAULT_SEED = std::uint64_t{42};
+
+    BetweennessCenterCalculator(const graph::Graph& graph,
+                                std::optional<std::size_t> number_of_samples = std::nullopt,
+                                std::uint64_t seed = DEFAULT_SEED)
+        : BetweennessCenterCalculator(graph,
+                                      PathFinder{graph},
+                                      number_of_samples,
+                                      seed) {}
+
+    BetweennessCenterCalculator(const graph::Graph& graph,
+                                PathFinder path_finder,
+                                std::optional<std::size_t> number_of_samples = std::nullopt,
+                                std::uint64_t seed = DEFAULT_SEED)
+        : graph_(graph),
+          path_finder_(path_finder),
+          betweenness_(calculateBetweenness(selectSources(number_of_samples, seed))) {}
+
+    auto calculateCenter(graph::Node from, graph::Node to) noexcept
+        -> std::optional<graph::Node>
+    {
+        auto path_opt = getPath(from, to);
+        if(!path_opt) {
+            return std::nullopt;
+        }
+
+        auto path = std::move(path_opt.value());
+        return findCenter(path);
+    }
+
+    // the (estimated) betweenness centrality of every node
+    [[nodiscard]] auto getBetweenness() const noexcept
+        -> const std::vector<double>&
+    {
+        return betweenness_;
+    }
+
+private:
+    // workspace of a single source search of Brandes' algorithm, counts the
+    // shortest paths to every node and accumulates the dependencies of the
+    // source on every node in reverse settle order
+    class DependencySearch
+    {
+    public:
+        DependencySearch(const graph::Graph& graph) noexcept
+            : graph_(graph),
+              distances_(graph.size(), graph::UNREACHABLE),
+              path_counts_(graph.size(), 0.0),
+              dependencies_(graph.size(), 0.0),
+              settled_(graph.size(), false),
+              pq_(pathfinding::DijkstraQueueComparer{}) {}
+
+        auto accumulateFrom(graph::Node source,
+                            std::vector<double>& betweenness) noexcept
+            -> void
+        {
+            reset();
+            countPathsFrom(source);
+
+            for(auto it = std::rbegin(settle_order_); it != std::rend(settle_order_); it++) {
+                const auto node = *it;
+                const auto coefficient = (1.0 + dependencies_[node]) / path_counts_[node];
+
+                for(auto [before, distance] : graph_.getBackwardNeigboursOf(node)) {
+                    if(settled_[before]
+                       and distances_[before] + distance == distances_[node]) {
+                        dependencies_[before] += path_counts_[before] * coefficient;
+                    }
+                }
+
+                if(node != source) {
+                    betweenness[node] += dependencies_[node];
+                }
+            }
+        }
+
+    private:
+        auto countPathsFrom(graph::Node source) noexcept
+            -> void
+        {
+            distances_[source] = 0;
+            path_counts_[source] = 1.0;
+            touched_.emplace_back(source);
+            pq_.emplace(source, 0l);
+
+            while(!pq_.empty()) {
+                auto [current_node, current_dist] = pq_.top();
+                pq_.pop();
+
+                if(settled_[current_node]) {
+                    continue;
+                }
+
+                settled_[current_node] = true;
+                settle_order_.emplace_back(current_node);
+
+                for(auto [neig, distance] : graph_.getForwardNeigboursOf(current_node)) {
+                    const auto new_dist = current_dist + distance;
+
+                    if(new_dist < distances_[neig]) {
+                        if(distances_[neig] == graph::UNREACHABLE) {
+                            touched_.emplace_back(neig);
+                        }
+
+                        distances_[neig] = new_dist;
+                        path_counts_[neig] = path_counts_[current_node];
+                        pq_.emplace(neig, new_dist);
+                    } else if(new_dist == distances_[neig] and !settled_[neig]) {
+                        path_counts_[neig] += path_counts_[current_node];
+                    }
+                }
+            }
+        }
+
+        auto reset() noexcept
+            -> void
+        {
+            for(auto n : touched_) {
+                distances_[n] = graph::UNREACHABLE;
+                path_counts_[n] = 0.0;
+                dependencies_[n] = 0.0;
+                settled_[n] = false;
+            }
+
+            touched_.clear();
+            settle_order_.clear();
+            pq_ = pathfinding::DijkstraQueue{pathfinding::DijkstraQueueComparer{}};
+        }
+
+    private:
+        const graph::Graph& graph_;
+        std::vector<graph::Distance> distances_;
+        std::vector<double> path_counts_;
+        std::vector<double> dependencies_;
+        std::vector<bool> settled_;
+        std::vector<graph::Node> touched_;
+        std::vector<graph::Node> settle_order_;
+        pathfinding::DijkstraQueue pq_;
+    };
+
+    [[nodiscard]] auto selectSources(std::optional<std::size_t> number_of_samples,
+                                     std::uint64_t seed) const noexcept
+        -> std::vector<graph::Node>
+    {
+        auto nodes = utils::range(graph_.size());
+        std::vector<graph::Node> sources;
+
+        if(!number_of_samples or number_of_samples.value() >= graph_.size()) {
+            sources.assign(std::begin(nodes), std::end(nodes));
+            return sources;
+        }
+
+        sources.reserve(number_of_samples.value());
+        std::sample(std::begin(nodes),
+                    std::end(nodes),
+                    std::back_inserter(sources),
+                    number_of_samples.value(),
+                    std::mt19937_64{seed});
+
+        return sources;
+    }
+
+    [[nodiscard]] auto calculateBetweenness(const std::vector<graph::Node>& sources) const noexcept
+        -> std::vector<double>
+    {
+        const auto graph_size = graph_.size();
+
+        tbb::enumerable_thread_specific<DependencySearch> searches{
+            [&] {
+                return DependencySearch{graph_};
+            }};
+
+        tbb::enumerable_thread_specific<std::vector<double>> local_betweenness{
+            [&] {
+                return std::vector<double>(graph_size, 0.0);
+            }};
+
+        progresscpp::ProgressBar bar{sources.size(), 80ul};
+        std::mutex bar_mutex;
+
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(0, sources.size()),
+            [&](const auto& range) {
+                auto& search = searches.local();
+                auto& betweenness = local_betweenness.local();
+
+                for(auto i = range.begin(); i != range.end(); i++) {
+                    search.accumulateFrom(sources[i], betweenness);
+
+                    std::lock_guard lock{bar_mutex};
+                    bar++;
+                    bar.displayIfChangedAtLeast(0.01);
+                }
+            });
+
+        bar.done();
+
+        std::vector<double> betweenness(graph_size, 0.0);
+        for(const auto& local : local_betweenness) {
+            std::transform(std::begin(local),
+                           std::end(local),
+                           std::begin(betweenness),
+                           std::begin(betweenness),
+                           std::plus<>{});
+        }
+
+        if(!sources.empty() and sources.size() < graph_size) {
+            const auto scale = static_cast<double>(graph_size)
+                / static_cast<double>(sources.size());
+
+            std::transform(std::begin(betweenness),
+                           std::end(betweenness),
+                           std::begin(betweenness),
+                           [&](auto value) {
+                               return value * scale;
+                           });
+        }
+
+        return betweenness;
+    }
+
+    auto getPath(graph::Node from, graph::Node to) noexcept
+        -> std::optional<pathfinding::Path>
+    {
+        return path_finder_.findRoute(from, to);
+    }
+
+    auto findCenter(const pathfinding::Path& path) const noexcept
+        -> std::optional<graph::Node>
+    {
+        if(path.empty()) {
+            return std::nullopt;
+        }
+
+        const auto& nodes = path.getNodes();
+
+        return *std::max_element(
+            std::begin(nodes),
+            std::end(nodes),
+            [&](auto lhs, auto rhs) {
+                return betweenness_[lhs] < betweenness_[rhs];
+            });
+    }
+
+private:
+    const graph::Graph& graph_;
+    PathFinder path_finder_;
+    std::vector<double> betweenness_;
+};
+
+} // namespace selection
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace selection {
+
+// path of the file in which the centrality of the given kind
+// is stored for the graph with the given fingerprint
+[[nodiscard]] auto centralityCachePath(std::string_view cache_folder,
+                                       std::string_view kind,
+                                       std::uint64_t fingerprint) noexcept
+    -> std::string;
+
+// reads a centrality vector written by storeCentrality, returns nothing if
+// the file does not exist or was written for another graph
+[[nodiscard]] auto loadCentrality(std::string_view path,
+                                  std::uint64_t fingerprint,
+                                  std::size_t number_of_nodes) noexcept
+    -> std::optional<std::vector<double>>;
+
+auto storeCentrality(std::string_view path,
+                     std::uint64_t fingerprint,
+                     const std::vector<double>& centrality) noexcept
+    -> bool;
+
+} // namespace selection
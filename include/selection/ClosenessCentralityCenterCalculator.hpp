@@ -3,11 +3,20 @@
 #include <cmath>
 #include <fmt/core.h>
 #include <graph/Graph.hpp>
+#include <mutex>
+#include <optional>
 #include <pathfinding/DijkstraQueue.hpp>
 #include <pathfinding/Distance.hpp>
+#include <pathfinding/OracleSlices.hpp>
 #include <pathfinding/Path.hpp>
+#include <progresscpp/ProgressBar.hpp>
 #include <queue>
+#include <selection/CentralityCache.hpp>
 #include <selection/NodeSelection.hpp>
+#include <string_view>
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
 #include <utils/Range.hpp>
 #include <vector>
 
@@ -20,35 +29,22 @@ class ClosenessCentralityCenterCalculator
 {
 public:
     ClosenessCentralityCenterCalculator(const graph::Graph& graph,
-                                        const DistanceOracle& distance_oracle)
-        : graph_(graph),
-          path_finder_(graph_),
-          closeness_centrality_(graph_.size(), 0.0)
-    {
-        auto graph_size = graph_.size();
-        auto node_range = utils::range(graph_size);
-        for(auto n : node_range) {
-            auto farness = std::transform_reduce(
-                std::begin(node_range),
-                std::end(node_range),
-                0l,
-                [](auto current, auto next) {
-                    if(next == graph::UNREACHABLE) {
-                        return current;
-                    }
-                    return current + next;
-                },
-                [&](auto from) {
-                    return distance_oracle.findDistance(from, n);
-                });
+                                        const DistanceOracle& distance_oracle,
+                                        std::optional<std::string_view> cache_folder = std::nullopt)
+        : ClosenessCentralityCenterCalculator(graph,
+                                              distance_oracle,
+                                              PathFinder{graph},
+                                              cache_folder) {}
 
-            auto closeness = static_cast<double>(graph_size)
-                / static_cast<double>(farness);
-
-            closeness_centrality_[n] = closeness;
-            fmt::print("closeness: {}\n", closeness);
-        }
-    }
+    // if a cache folder is given, the centrality is reused from
+    // an earlier run on the same graph or stored for later runs
+    ClosenessCentralityCenterCalculator(const graph::Graph& graph,
+                                        const DistanceOracle& distance_oracle,
+                                        PathFinder path_finder,
+                                        std::optional<std::string_view> cache_folder = std::nullopt)
+        : graph_(graph),
+          path_finder_(path_finder),
+          closeness_centrality_(loadOrCalculateCloseness(distance_oracle, cache_folder)) {}
 
     auto calculateCenter(graph::Node from, graph::Node to) noexcept
         -> std::optional<graph::Node>
@@ -62,7 +58,106 @@ public:
         return findCenter(path);
     }
 
+    // the closeness centrality of every node
+    [[nodiscard]] auto getCloseness() const noexcept
+        -> const std::vector<double>&
+    {
+        return closeness_centrality_;
+    }
+
 private:
+    [[nodiscard]] auto loadOrCalculateCloseness(const DistanceOracle& distance_oracle,
+                                                std::optional<std::string_view> cache_folder) const noexcept
+        -> std::vector<double>
+    {
+        if(!cache_folder) {
+            return calculateCloseness(distance_oracle);
+        }
+
+        const auto fingerprint = graph_.fingerprint();
+        const auto path = centralityCachePath(cache_folder.value(),
+                                              "closeness",
+                                              fingerprint);
+
+        auto cached_opt = loadCentrality(path, fingerprint, graph_.size());
+        if(cached_opt) {
+            return std::move(cached_opt.value());
+        }
+
+        auto closeness = calculateCloseness(distance_oracle);
+        if(!storeCentrality(path, fingerprint, closeness)) {
+            fmt::print(stderr, "unable to store the closeness centrality in {}\n", path);
+        }
+
+        return closeness;
+    }
+
+    // the farness of a node is the sum of the distances from all other nodes
+    // to it. The sums are accumulated row by row, such that every thread reads
+    // complete rows of the oracle and adds them into its own farness vector
+    [[nodiscard]] auto calculateCloseness(const DistanceOracle& distance_oracle) const noexcept
+        -> std::vector<double>
+    {
+        const auto graph_size = graph_.size();
+
+        tbb::enumerable_thread_specific<std::vector<graph::Distance>> local_farness{
+            [&] {
+                return std::vector<graph::Distance>(graph_size, 0);
+            }};
+
+        progresscpp::ProgressBar bar{graph_size, 80ul};
+        std::mutex bar_mutex;
+
+        tbb::parallel_for(
+            tbb::blocked_range<graph::Node>(0, graph_size),
+            [&](const auto& rows) {
+                auto& farness = local_farness.local();
+
+                for(auto from = rows.begin(); from != rows.end(); from++) {
+                    const auto from_source = pathfinding::distancesFrom(distance_oracle, from);
+
+                    for(graph::Node to = 0; to < graph_size; to++) {
+                        const auto distance = from_source[to];
+                        if(distance != graph::UNREACHABLE) {
+                            farness[to] += distance;
+                        }
+                    }
+
+                    std::lock_guard lock{bar_mutex};
+                    bar++;
+                    bar.displayIfChangedAtLeast(0.01);
+                }
+            });
+
+        bar.done();
+
+        std::vector<graph::Distance> farness(graph_size, 0);
+        for(const auto& local : local_farness) {
+            std::transform(std::begin(local),
+                           std::end(local),
+                           std::begin(farness),
+                           std::begin(farness),
+                           std::plus<>{});
+        }
+
+        std::vector<double> closeness(graph_size);
+        std::transform(std::begin(farness),
+                       std::end(farness),
+                       std::begin(closeness),
+                       [&](auto node_farness) {
+                           //no other node reaches the node, or only over zero weight
+                           //edges, which would otherwise make it the most central one
+                           if(node_farness == 0) {
+                               return 0.0;
+                           }
+
+                           return static_cast<double>(graph_size)
+                               / static_cast<double>(node_farness);
+                       });
+
+        return closeness;
+    }
+
     auto getPath(graph::Node from, graph::Node to) noexcept
         -> std::optional<pathfinding::Path>
     {
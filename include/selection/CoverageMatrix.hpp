@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <graph/Graph.hpp>
+#include <utility>
+#include <utils/FenwickTree.hpp>
+#include <vector>
+
+namespace selection {
+
+// remembers which source target pairs are already covered by a selection. Every
+// row is a bitmap of 64 bit words with a cached number of uncovered pairs, a
+// row without uncovered pairs is freed. The number of uncovered pairs of the
+// whole matrix is kept as well, so checking if all pairs are covered is O(1).
+// A fenwick tree over the row counters and the number of uncovered pairs per
+// block of 512 columns find the k-th uncovered pair without scanning the rows
+class CoverageMatrix
+{
+public:
+    // all pairs start out covered, the pairs of interest are uncovered afterwards
+    explicit CoverageMatrix(std::size_t number_of_nodes) noexcept;
+    CoverageMatrix() = delete;
+    CoverageMatrix(CoverageMatrix&&) = default;
+    CoverageMatrix(const CoverageMatrix&) = delete;
+    auto operator=(const CoverageMatrix&) -> CoverageMatrix& = delete;
+    auto operator=(CoverageMatrix&&) -> CoverageMatrix& = delete;
+
+    [[nodiscard]] auto isCovered(graph::Node from, graph::Node to) const noexcept
+        -> bool;
+
+    // true if all pairs starting at from are covered
+    [[nodiscard]] auto isDone(graph::Node from) const noexcept
+        -> bool;
+
+    // true if all pairs are covered
+    [[nodiscard]] auto done() const noexcept
+        -> bool;
+
+    [[nodiscard]] auto remainingIn(graph::Node from) const noexcept
+        -> std::size_t;
+
+    [[nodiscard]] auto remaining() const noexcept
+        -> std::size_t;
+
+    // the k-th uncovered pair in row major order, k < remaining()
+    [[nodiscard]] auto findUncovered(std::size_t k) const noexcept
+        -> std::pair<graph::Node, graph::Node>;
+
+    auto uncover(graph::Node from, graph::Node to) noexcept
+        -> void;
+
+    auto cover(graph::Node from, graph::Node to) noexcept
+        -> void;
+
+    // covers all pairs from a node of the source patch to a node of the target
+    // patch and returns how many of them were not covered before. The target
+    // patch is turned into a mask once, which is or'ed into every source row,
+    // touching only the words which hold a target. The patches can be a Patch
+    // or a view of a patch in a SelectionStore
+    template<class SourcePatch, class TargetPatch>
+    auto cover(const SourcePatch& sources, const TargetPatch& targets) noexcept
+        -> std::size_t
+    {
+        for(auto [target, _] : targets) {
+            addToTargetMask(target);
+        }
+
+        std::size_t covered = 0;
+        for(auto [source, _] : sources) {
+            covered += coverMaskedTargetsOf(source);
+        }
+
+        clearTargetMask();
+
+        return covered;
+    }
+
+private:
+    [[nodiscard]] static auto wordOf(graph::Node n) noexcept
+        -> std::size_t;
+
+    [[nodiscard]] static auto bitOf(graph::Node n) noexcept
+        -> std::uint64_t;
+
+    [[nodiscard]] static auto blockOf(std::size_t word) noexcept
+        -> std::size_t;
+
+    auto addToTargetMask(graph::Node target) noexcept
+        -> void;
+
+    auto coverMaskedTargetsOf(graph::Node source) noexcept
+        -> std::size_t;
+
+    auto clearTargetMask() noexcept
+        -> void;
+
+    auto changeRemaining(graph::Node from, long long delta) noexcept
+        -> void;
+
+    auto freeIfDone(graph::Node from) noexcept
+        -> void;
+
+private:
+    std::size_t words_per_row_;
+    std::size_t blocks_per_row_;
+    std::vector<std::vector<std::uint64_t>> rows_;
+    std::vector<std::vector<std::uint16_t>> remaining_in_block_;
+    std::vector<std::size_t> remaining_in_row_;
+    utils::FenwickTree remaining_tree_;
+    std::size_t remaining_ = 0;
+
+    //mask of the current target patch and the indices of its non zero words
+    std::vector<std::uint64_t> target_mask_;
+    std::vector<std::size_t> mask_words_;
+};
+
+} // namespace selection
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <algorithm>
+#include <graph/Graph.hpp>
+#include <optional>
+#include <pathfinding/Distance.hpp>
+#include <pathfinding/OracleSlices.hpp>
+#include <queue>
+#include <selection/CoverageMatrix.hpp>
+#include <utility>
+#include <utils/Range.hpp>
+#include <utils/Utils.hpp>
+#include <vector>
+
+namespace selection {
+
+// hands out the uncovered pairs farthest first. The heap holds one entry per
+// source, keyed by the distance to its farthest uncovered target, instead of
+// one entry per pair. The targets of a source are only sorted once the source
+// reaches the top of the heap, and only a window of the farthest ones is kept,
+// which is refilled from the distances when it runs out. Every refill doubles
+// the window, such that a source is scanned O(log n) times and its window is
+// at most twice as large as the targets it handed out. Keys which became too
+// large because their pairs were covered in the meantime are corrected when
+// they are popped
+template<class DistanceOracle>
+class FarthestPairQueue
+{
+public:
+    FarthestPairQueue(const DistanceOracle& distance_oracle,
+                      const CoverageMatrix& coverage,
+                      std::size_t number_of_nodes) noexcept
+        : distance_oracle_(distance_oracle),
+          coverage_(coverage),
+          number_of_nodes_(number_of_nodes),
+          targets_(number_of_nodes),
+          next_target_(number_of_nodes, 0),
+          window_sizes_(number_of_nodes, 0)
+    {
+        for(auto source : utils::range(number_of_nodes)) {
+            if(coverage_.isDone(source)) {
+                continue;
+            }
+
+            const auto from_source = pathfinding::distancesFrom(distance_oracle_, source);
+            graph::Distance farthest = 0;
+            for(auto target : utils::range(number_of_nodes)) {
+                if(!coverage_.isCovered(source, target)) {
+                    farthest = std::max(farthest, from_source[target]);
+                }
+            }
+
+            heap_.emplace(farthest, source);
+        }
+    }
+
+    // the farthest pair which is still uncovered. Every pair is handed out
+    // once, nothing is returned if all pairs were handed out
+    [[nodiscard]] auto pop() noexcept
+        -> std::optional<std::pair<graph::Node, graph::Node>>
+    {
+        while(!heap_.empty()) {
+            auto [key, source] = heap_.top();
+            heap_.pop();
+
+            auto next = nextUncovered(source);
+            if(!next) {
+                utils::cleanAndFree(targets_[source]);
+                continue;
+            }
+
+            auto [target, distance] = next.value();
+
+            //the key was too large, the source has to wait for its turn
+            if(distance < key) {
+                heap_.emplace(distance, source);
+                continue;
+            }
+
+            next_target_[source]++;
+            heap_.emplace(distance, source);
+            return std::pair{source, target};
+        }
+
+        return std::nullopt;
+    }
+
+private:
+    // the farthest target of the source which was not handed out yet and is
+    // uncovered, together with its distance
+    [[nodiscard]] auto nextUncovered(graph::Node source) noexcept
+        -> std::optional<std::pair<graph::Node, graph::Distance>>
+    {
+        if(coverage_.isDone(source)) {
+            return std::nullopt;
+        }
+
+        auto& targets = targets_[source];
+        auto& next = next_target_[source];
+
+        while(true) {
+            if(window_sizes_[source] == 0 or next == targets.size()) {
+                if(!refillTargets(source)) {
+                    return std::nullopt;
+                }
+            }
+
+            if(!coverage_.isCovered(source, targets[next])) {
+                break;
+            }
+
+            next++;
+        }
+
+        const auto target = targets[next];
+        return std::pair{target, pathfinding::distancesFrom(distance_oracle_, source)[target]};
+    }
+
+    // replaces the window of the source by its next uncovered targets, twice as
+    // many as before, ordered by decreasing distance and increasing id. The
+    // order continues after the last target of the previous window, such that
+    // every target is in exactly one window. Returns false if none are left
+    [[nodiscard]] auto refillTargets(graph::Node source) noexcept
+        -> bool
+    {
+        const auto from_source = pathfinding::distancesFrom(distance_oracle_, source);
+        auto& targets = targets_[source];
+
+        const auto is_before = [&](auto lhs, auto rhs) {
+            return from_source[lhs] > from_source[rhs]
+                or (from_source[lhs] == from_source[rhs] and lhs < rhs);
+        };
+
+        std::optional<std::uint32_t> last;
+        if(window_sizes_[source] != 0 and !targets.empty()) {
+            last = targets.back();
+        }
+
+        candidates_.clear();
+        for(auto target : utils::range(number_of_nodes_)) {
+            if((!last or is_before(last.value(), target))
+               and !coverage_.isCovered(source, target)) {
+                candidates_.emplace_back(target);
+            }
+        }
+
+        window_sizes_[source] = window_sizes_[source] == 0
+            ? INITIAL_WINDOW_SIZE
+            : 2 * window_sizes_[source];
+
+        const auto window_size = std::min(candidates_.size(), window_sizes_[source]);
+        //the windows grow large, a selection and a sort of the window
+        //are cheaper than a partial sort of that size
+        std::nth_element(std::begin(candidates_),
+                         std::begin(candidates_) + window_size,
+                         std::end(candidates_),
+                         is_before);
+        std::sort(std::begin(candidates_),
+                  std::begin(candidates_) + window_size,
+                  is_before);
+
+        targets.assign(std::begin(candidates_),
+                       std::begin(candidates_) + window_size);
+
+        next_target_[source] = 0;
+
+        return !targets.empty();
+    }
+
+private:
+    //the first window of a source, the queue needs O(n) memory instead of
+    //O(n^2) as long as the sources hand out only few of their targets
+    static constexpr std::size_t INITIAL_WINDOW_SIZE = 64;
+
+    const DistanceOracle& distance_oracle_;
+    const CoverageMatrix& coverage_;
+    std::size_t number_of_nodes_;
+
+    std::priority_queue<std::pair<graph::Distance, graph::Node>> heap_;
+
+    //the next targets of every source sorted by decreasing distance, once it was popped
+    std::vector<std::vector<std::uint32_t>> targets_;
+    std::vector<std::size_t> next_target_;
+    //the size of the current window of every source, zero if it has none yet
+    std::vector<std::size_t> window_sizes_;
+
+    //the uncovered targets of the source which is refilled
+    std::vector<std::uint32_t> candidates_;
+};
+
+} // namespace selection
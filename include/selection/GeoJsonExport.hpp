@@ -0,0 +1,130 @@
+#pragma once
+
+#include <algorithm>
+#include <fmt/format.h>
+#include <fstream>
+#include <graph/Graph.hpp>
+#include <optional>
+#include <selection/SelectionStore.hpp>
+#include <string>
+#include <string_view>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <utils/Range.hpp>
+#include <vector>
+
+namespace selection {
+
+enum class GeoJsonLayout {
+    // a single FeatureCollection object
+    FEATURE_COLLECTION,
+    // one Feature per line
+    NEWLINE_DELIMITED
+};
+
+struct GeoJsonOptions
+{
+    GeoJsonLayout layout = GeoJsonLayout::FEATURE_COLLECTION;
+
+    // number of decimals of the written coordinates, all of them if not set
+    std::optional<int> decimals = std::nullopt;
+
+    // only the first this many selections of the container are written
+    std::optional<std::size_t> limit = std::nullopt;
+};
+
+// appends the features of a selection to the buffer, one MultiPoint with the
+// sources, one with the targets and a Point with the center. All of them name
+// the index of the selection and their role in it, such that a viewer can
+// style and filter them. Every feature is preceded by the separator of the
+// layout unless it is the first one in the buffer
+auto appendGeoJsonFeatures(fmt::memory_buffer& buffer,
+                           const graph::Graph& graph,
+                           const SelectionView& selection,
+                           std::size_t index,
+                           const GeoJsonOptions& options) noexcept
+    -> void;
+
+// streams the selections into a GeoJSON file without building a document in
+// memory. The selections are formatted in parallel chunks into buffers which
+// are written in order, such that at most one round of chunks is held at once
+class GeoJsonWriter
+{
+public:
+    GeoJsonWriter(std::string path,
+                  GeoJsonOptions options) noexcept;
+
+    // removes the file if it was not finished
+    ~GeoJsonWriter() noexcept;
+
+    GeoJsonWriter() = delete;
+    GeoJsonWriter(GeoJsonWriter&&) = delete;
+    GeoJsonWriter(const GeoJsonWriter&) = delete;
+    auto operator=(const GeoJsonWriter&) -> GeoJsonWriter& = delete;
+    auto operator=(GeoJsonWriter&&) -> GeoJsonWriter& = delete;
+
+    // the selections are a SelectionStore or a SelectionFile
+    template<class Selections>
+    [[nodiscard]] auto write(const graph::Graph& graph,
+                             const Selections& selections) noexcept
+        -> bool
+    {
+        const auto number_of_selections = std::min(selections.size(),
+                                                   options_.limit.value_or(selections.size()));
+
+        std::vector<fmt::memory_buffer> buffers(CHUNKS_PER_ROUND);
+
+        for(std::size_t round_begin = 0;
+            round_begin < number_of_selections;
+            round_begin += CHUNKS_PER_ROUND * SELECTIONS_PER_CHUNK) {
+
+            tbb::parallel_for(
+                tbb::blocked_range<std::size_t>(0, CHUNKS_PER_ROUND, 1),
+                [&](const auto& range) {
+                    for(auto chunk = range.begin(); chunk != range.end(); chunk++) {
+                        auto& buffer = buffers[chunk];
+                        buffer.clear();
+
+                        const auto begin = std::min(round_begin + chunk * SELECTIONS_PER_CHUNK,
+                                                    number_of_selections);
+                        const auto end = std::min(begin + SELECTIONS_PER_CHUNK,
+                                                  number_of_selections);
+
+                        for(auto i : utils::range(begin, end)) {
+                            appendGeoJsonFeatures(buffer,
+                                                  graph,
+                                                  selections[i],
+                                                  i,
+                                                  options_);
+                        }
+                    }
+                });
+
+            for(const auto& buffer : buffers) {
+                writeChunk(buffer);
+            }
+        }
+
+        return finish();
+    }
+
+private:
+    static constexpr std::size_t SELECTIONS_PER_CHUNK = 64;
+    static constexpr std::size_t CHUNKS_PER_ROUND = 64;
+
+    auto writeChunk(const fmt::memory_buffer& buffer) noexcept
+        -> void;
+
+    auto finish() noexcept
+        -> bool;
+
+private:
+    std::string path_;
+    std::string tmp_path_;
+    GeoJsonOptions options_;
+    std::ofstream file_;
+    bool is_empty_ = true;
+    bool finished_ = false;
+};
+
+} // namespace selection
@@ -17,8 +17,14 @@ class MiddleChoosingCenterCalculator
 {
 public:
     MiddleChoosingCenterCalculator(const graph::Graph& graph)
+        : MiddleChoosingCenterCalculator(graph, PathFinder{graph}) {}
+
+    // PathFinder can be a reference to an oracle which answers
+    // routes without a search, like a CachingDijkstra with predecessors
+    MiddleChoosingCenterCalculator(const graph::Graph& graph,
+                                   PathFinder path_finder)
         : graph_(graph),
-          path_finder_(graph_){}
+          path_finder_(path_finder) {}
 
     auto calculateCenter(graph::Node from, graph::Node to) noexcept
         -> std::optional<graph::Node>
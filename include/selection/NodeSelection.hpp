@@ -3,6 +3,7 @@
 #include <execution>
 #include <graph/Graph.hpp>
 #include <nlohmann/json.hpp>
+#include <pathfinding/OracleSlices.hpp>
 #include <string_view>
 #include <vector>
 
@@ -98,45 +99,19 @@ template<class DistanceOracle>
         std::begin(first_sources),
         std::end(first_sources),
         [&](auto pair) {
-            auto source = pair.first;
-            auto source_center = pair.second;
-            return std::all_of(
-                std::begin(second_targets),
-                std::end(second_targets),
-                [&](auto inner_pair) {
-                    auto [target, _] = inner_pair;
-
-                    auto true_dist = oracle.findDistance(source, target);
-                    auto center_target = oracle.findDistance(center, target);
-
-                    return source_center + center_target == true_dist;
-                });
+            return pathfinding::centerOnPathsFrom(oracle, pair.first, center, second_targets);
         });
 
     if(!first_condition) {
         return false;
     }
 
-    auto second_condition = std::all_of(
+    return std::all_of(
         std::begin(first_targets),
         std::end(first_targets),
         [&](auto pair) {
-            auto target = pair.first;
-            auto center_target = pair.second;
-            return std::all_of(
-                std::begin(second_sources),
-                std::end(second_sources),
-                [&](auto inner_pair) {
-                    auto [source, _] = inner_pair;
-
-                    auto true_dist = oracle.findDistance(source, target);
-                    auto source_center = oracle.findDistance(source, center);
-
-                    return source_center + center_target == true_dist;
-                });
+            return pathfinding::centerOnPathsTo(oracle, pair.first, center, second_sources);
         });
-
-    return second_condition;
 }
 
 template<class DistanceOracle>
@@ -152,18 +127,18 @@ template<class DistanceOracle>
     std::transform(std::begin(second.getSourcePatch()),
                    std::end(second.getSourcePatch()),
                    std::back_inserter(source_patch),
-                   [&](auto pair) {
+                   [&, to_center = pathfinding::distancesTo(oracle, center)](auto pair) {
                        auto [source, _] = pair;
-                       auto dist = oracle.findDistance(source, center);
+                       auto dist = to_center[source];
                        return std::pair{source, dist};
                    });
 
     std::transform(std::begin(second.getTargetPatch()),
                    std::end(second.getTargetPatch()),
                    std::back_inserter(target_patch),
-                   [&](auto pair) {
+                   [&, from_center = pathfinding::distancesFrom(oracle, center)](auto pair) {
                        auto [target, _] = pair;
-                       auto dist = oracle.findDistance(center, target);
+                       auto dist = from_center[target];
                        return std::pair{target, dist};
                    });
 
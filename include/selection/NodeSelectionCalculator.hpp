@@ -2,13 +2,44 @@
 
 #include <fmt/core.h>
 #include <graph/Graph.hpp>
+#include <optional>
 #include <pathfinding/Distance.hpp>
+#include <pathfinding/IncrementalDijkstra.hpp>
+#include <pathfinding/OracleSlices.hpp>
 #include <queue>
+#include <selection/AffiliationFilter.hpp>
+#include <selection/CoverageMatrix.hpp>
 #include <selection/NodeSelection.hpp>
+#include <selection/SelectionStore.hpp>
 #include <vector>
 
 namespace selection {
 
+// limits the candidates which are tried when a selection is grown. Without
+// limits every node of the graph is tried, otherwise the candidates are taken
+// from a backward and a forward search around the center, closest first
+struct CandidateLimits
+{
+    // a side stops growing after this many candidates in a row were rejected
+    std::optional<std::size_t> max_consecutive_failures;
+    // a side stops growing once the candidates are further away from the center
+    std::optional<graph::Distance> max_radius;
+
+    [[nodiscard]] auto isLocal() const noexcept
+        -> bool
+    {
+        return max_consecutive_failures.has_value() or max_radius.has_value();
+    }
+};
+
+enum class CandidateResult {
+    ACCEPTED,
+    // the candidate would cover no path which is not covered yet
+    NOTHING_NEW,
+    // the center is not on the shortest paths of the candidate
+    REJECTED
+};
+
 template<class CenterCalculator,
          class DistanceOracle>
 class NodeSelectionCalculator
@@ -17,19 +48,29 @@ public:
     NodeSelectionCalculator(const DistanceOracle& cached_path_finder,
                             CenterCalculator center_calculator,
                             const graph::Graph& graph,
-                            const std::vector<std::vector<bool>>& coverage)
+                            const CoverageMatrix& coverage,
+                            CandidateLimits candidate_limits = {})
         : distance_oracle_(cached_path_finder),
           center_calculator_(center_calculator),
           graph_(graph),
-          coverage_(coverage) {}
-
+          coverage_(coverage),
+          candidate_limits_(candidate_limits),
+          backward_search_(graph, pathfinding::IncrementalDijkstra::Direction::BACKWARD),
+          forward_search_(graph, pathfinding::IncrementalDijkstra::Direction::FORWARD),
+          source_filter_(cached_path_finder, graph.size()),
+          target_filter_(cached_path_finder, graph.size()) {}
+
+    // grows a selection around the center of the seed pair and appends it to
+    // the store, returns false if the seed pair has no center. The patches are
+    // built in buffers which are kept from one selection to the next
     [[nodiscard]] auto calculateFullSelection(graph::Node source_start,
-                                              graph::Node target_start) noexcept
-        -> std::optional<NodeSelection>
+                                              graph::Node target_start,
+                                              SelectionStore& store) noexcept
+        -> bool
     {
         auto center_opt = calculateCenter(source_start, target_start);
         if(!center_opt) {
-            return std::nullopt;
+            return false;
         }
         auto center = center_opt.value();
 
@@ -43,6 +84,38 @@ public:
         source_patch_.emplace_back(center, 0);
         target_patch_.emplace_back(center, 0);
 
+        //sources without uncovered pairs are never accepted
+        if(source_filter_.isContiguous()) {
+            source_filter_.reset(center, target_patch_, [&](auto n) {
+                return !coverage_.isDone(n);
+            });
+        }
+        if(target_filter_.isContiguous()) {
+            target_filter_.reset(center, source_patch_, [](auto) {
+                return true;
+            });
+        }
+
+        if(candidate_limits_.isLocal()) {
+            growAroundCenter(center, source_start, target_start);
+        } else {
+            growOverAllNodes(center, source_start, target_start);
+        }
+
+        store.add(source_patch_, target_patch_, center, false);
+
+        //cleanup and reset the state of the calculator
+        cleanup();
+
+        return true;
+    }
+
+private:
+    auto growOverAllNodes(graph::Node center,
+                          graph::Node source_start,
+                          graph::Node target_start) noexcept
+        -> void
+    {
         auto last_node = graph_.size();
 
         graph::Node current_src_candidate = 0;
@@ -51,48 +124,105 @@ public:
         while(current_src_candidate < last_node or current_trg_candidate < last_node) {
 
             while(current_src_candidate < last_node
-                  and !processSourceCandidate(current_src_candidate,
-                                              center,
-                                              source_start)) {
+                  and processSourceCandidate(current_src_candidate,
+                                             center,
+                                             source_start)
+                      != CandidateResult::ACCEPTED) {
                 current_src_candidate++;
             }
 
             while(current_trg_candidate < last_node
-                  and !processTargetCandidate(current_trg_candidate,
-                                              center,
-                                              target_start)) {
+                  and processTargetCandidate(current_trg_candidate,
+                                             center,
+                                             target_start)
+                      != CandidateResult::ACCEPTED) {
                 current_trg_candidate++;
             }
 
             current_trg_candidate++;
             current_src_candidate++;
         }
+    }
 
-        //create the selection which was found
-        NodeSelection selection{std::move(source_patch_),
-                                std::move(target_patch_),
-                                center,
-                                false};
+    // sources are taken from the backward search and targets from the forward
+    // search around the center, the sides alternate like in growOverAllNodes
+    auto growAroundCenter(graph::Node center,
+                          graph::Node source_start,
+                          graph::Node target_start) noexcept
+        -> void
+    {
+        backward_search_.start(center);
+        forward_search_.start(center);
+
+        bool sources_done = false;
+        bool targets_done = false;
+
+        while(!sources_done or !targets_done) {
+            sources_done = sources_done
+                or !growFromSearch(backward_search_, center, source_start, [&](auto node) {
+                       return processSourceCandidate(node, center, source_start);
+                   });
+
+            targets_done = targets_done
+                or !growFromSearch(forward_search_, center, target_start, [&](auto node) {
+                       return processTargetCandidate(node, center, target_start);
+                   });
+        }
+    }
 
-        //cleanup and reset the state of the calculator
-        cleanup();
+    // advances the search until one candidate was accepted. Returns false if
+    // the search is exhausted or one of the candidate limits was reached.
+    // Candidates which would cover nothing new do not count as failures, they
+    // say nothing about how far the shortest paths through the center reach
+    template<class Process>
+    [[nodiscard]] auto growFromSearch(pathfinding::IncrementalDijkstra& search,
+                                      graph::Node center,
+                                      graph::Node start,
+                                      Process&& process) const noexcept
+        -> bool
+    {
+        std::size_t failures = 0;
 
-        return selection;
+        while(auto next = search.settleNext()) {
+            auto [node, distance] = next.value();
+
+            if(candidate_limits_.max_radius
+               and distance > candidate_limits_.max_radius.value()) {
+                return false;
+            }
+
+            //the start and the center are already part of the patches
+            if(node == start or node == center) {
+                continue;
+            }
+
+            auto result = process(node);
+            if(result == CandidateResult::ACCEPTED) {
+                return true;
+            }
+
+            if(result == CandidateResult::REJECTED
+               and candidate_limits_.max_consecutive_failures
+               and ++failures >= candidate_limits_.max_consecutive_failures.value()) {
+                return false;
+            }
+        }
+
+        return false;
     }
 
-private:
     [[nodiscard]] auto processSourceCandidate(graph::Node node,
 											  graph::Node center,
 											  graph::Node start) noexcept
-        -> bool
+        -> CandidateResult
     {
         if(node == start or node == center) {
-            return false;
+            return CandidateResult::NOTHING_NEW;
         }
 
 
         if(countNewPathsForSource(node) == 0) {
-            return false;
+            return CandidateResult::NOTHING_NEW;
         }
 
         auto source_dist_opt = checkSourceAffiliation(node,
@@ -102,24 +232,28 @@ private:
             auto source_dist = source_dist_opt.value();
             source_patch_.emplace_back(node, source_dist);
 
-            return true;
+            if(target_filter_.isContiguous()) {
+                target_filter_.add(node, source_dist);
+            }
+
+            return CandidateResult::ACCEPTED;
         }
 
-        return false;
+        return CandidateResult::REJECTED;
     }
 
     [[nodiscard]] auto processTargetCandidate(graph::Node node,
 											  graph::Node center,
 											  graph::Node start) noexcept
-        -> bool
+        -> CandidateResult
     {
         if(node == start or node == center) {
-            return false;
+            return CandidateResult::NOTHING_NEW;
         }
 
 
         if(countNewPathsForTarget(node) == 0) {
-            return false;
+            return CandidateResult::NOTHING_NEW;
         }
 
         auto target_dist_opt = checkTargetAffiliation(node,
@@ -129,10 +263,14 @@ private:
             auto target_dist = target_dist_opt.value();
             target_patch_.emplace_back(node, target_dist);
 
-            return true;
+            if(source_filter_.isContiguous()) {
+                source_filter_.add(node, target_dist);
+            }
+
+            return CandidateResult::ACCEPTED;
         }
 
-        return false;
+        return CandidateResult::REJECTED;
     }
 
     [[nodiscard]] auto checkSourceAffiliation(graph::Node source,
@@ -140,23 +278,19 @@ private:
                                               const Patch& targets) noexcept
         -> std::optional<graph::Distance>
     {
-        auto center_dist = distance_oracle_.findDistance(source, center);
+        //the filter already checked the candidate against the whole patch
+        if(source_filter_.isContiguous()) {
+            return source_filter_.affiliation(source);
+        }
+
+        const auto from_source = pathfinding::distancesFrom(distance_oracle_, source);
+        auto center_dist = from_source[center];
 
         if(center_dist == graph::UNREACHABLE) {
             return std::nullopt;
         }
 
-        auto valid = std::all_of(
-            std::begin(targets),
-            std::end(targets),
-            [&](auto pair) {
-                auto [target, center_target_dist] = pair;
-                auto dist = distance_oracle_.findDistance(source, target);
-
-                return center_dist + center_target_dist == dist;
-            });
-
-        if(!valid) {
+        if(!from_source.matchesAll(center_dist, targets)) {
             return std::nullopt;
         }
 
@@ -168,23 +302,19 @@ private:
                                               const Patch& sources) noexcept
         -> std::optional<graph::Distance>
     {
-        auto center_dist = distance_oracle_.findDistance(center, target);
+        //the filter already checked the candidate against the whole patch
+        if(target_filter_.isContiguous()) {
+            return target_filter_.affiliation(target);
+        }
+
+        const auto to_target = pathfinding::distancesTo(distance_oracle_, target);
+        auto center_dist = to_target[center];
 
         if(center_dist == graph::UNREACHABLE) {
             return std::nullopt;
         }
 
-        auto valid = std::all_of(
-            std::begin(sources),
-            std::end(sources),
-            [&](auto pair) {
-                auto [source, source_center_dist] = pair;
-
-                auto dist = distance_oracle_.findDistance(source, target);
-                return center_dist + source_center_dist == dist;
-            });
-
-        if(!valid) {
+        if(!to_target.matchesAll(center_dist, sources)) {
             return std::nullopt;
         }
 
@@ -214,16 +344,14 @@ private:
             std::end(source_patch_),
             [&](auto pair) {
                 auto [source, _] = pair;
-                return !coverage_[source].empty()
-                    and !coverage_[source][target];
+                return !coverage_.isCovered(source, target);
             });
     }
 
     [[nodiscard]] auto countNewPathsForSource(graph::Node source) const noexcept
         -> std::size_t
     {
-        const auto& source_vec = coverage_[source];
-        if(source_vec.empty()) {
+        if(coverage_.isDone(source)) {
             return 0;
         }
 
@@ -232,7 +360,7 @@ private:
             std::end(target_patch_),
             [&](auto pair) {
                 auto [target, _] = pair;
-                return !source_vec[target];
+                return !coverage_.isCovered(source, target);
             });
     }
 
@@ -244,7 +372,14 @@ private:
 
     Patch source_patch_;
     Patch target_patch_;
-    const std::vector<std::vector<bool>>& coverage_;
+    const CoverageMatrix& coverage_;
+
+    CandidateLimits candidate_limits_;
+    pathfinding::IncrementalDijkstra backward_search_;
+    pathfinding::IncrementalDijkstra forward_search_;
+
+    AffiliationFilter<DistanceOracle, true> source_filter_;
+    AffiliationFilter<DistanceOracle, false> target_filter_;
 };
 
 } // namespace selection
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <graph/Graph.hpp>
+#include <optional>
+#include <pathfinding/Distance.hpp>
+#include <pathfinding/OracleSlices.hpp>
+#include <pathfinding/PathWalk.hpp>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace selection {
+
+template<class DistanceOracle, class = void>
+struct has_predecessors : std::false_type
+{
+};
+
+template<class DistanceOracle>
+struct has_predecessors<DistanceOracle,
+                        std::void_t<decltype(std::declval<const DistanceOracle&>()
+                                                 .findPredecessor(graph::Node{}, graph::Node{})),
+                                    decltype(std::declval<const DistanceOracle&>()
+                                                 .hasPredecessors())>>
+    : std::true_type
+{
+};
+
+// chooses the center of a shortest path with the distance oracle alone. The
+// path is walked backwards from the target: the node before a node c is taken
+// from the oracle if it keeps the predecessors, otherwise it is a backward
+// neighbour u with d(s, u) + w(u, c) = d(s, c) as chosen by walkPathBackwards,
+// which also finds its way out of zero weight cycles. No search is run and no
+// path is materialised. Without scores the node at the same position as
+// Path::getMiddleNode is chosen, otherwise the node with the highest score
+template<class DistanceOracle>
+class OracleCenterCalculator
+{
+public:
+    OracleCenterCalculator(const graph::Graph& graph,
+                           const DistanceOracle& distance_oracle,
+                           std::optional<std::vector<double>> scores = std::nullopt)
+        : graph_(graph),
+          distance_oracle_(distance_oracle),
+          scores_(std::move(scores)) {}
+
+    auto calculateCenter(graph::Node from, graph::Node to) noexcept
+        -> std::optional<graph::Node>
+    {
+        const auto from_source = pathfinding::distancesFrom(distance_oracle_, from);
+
+        if(from_source[to] == graph::UNREACHABLE) {
+            return std::nullopt;
+        }
+
+        if(scores_) {
+            return findBestScoringNode(from, to, from_source);
+        }
+
+        return findMiddleNode(from, to, from_source);
+    }
+
+private:
+    template<class Slice>
+    [[nodiscard]] auto findMiddleNode(graph::Node from,
+                                      graph::Node to,
+                                      const Slice& from_source) const noexcept
+        -> std::optional<graph::Node>
+    {
+        std::size_t number_of_nodes = 1;
+        auto walkable = walkPath(from, to, from_source, [&](auto) {
+            number_of_nodes++;
+            return true;
+        });
+
+        if(!walkable) {
+            return std::nullopt;
+        }
+
+        //the path is walked from the back, the middle node of
+        //the path is number_of_nodes - 1 - middle steps away
+        const auto middle_index = number_of_nodes / 2;
+        auto steps = number_of_nodes - 1 - middle_index;
+
+        if(steps == 0) {
+            return to;
+        }
+
+        std::optional<graph::Node> middle;
+        [[maybe_unused]] auto _ = walkPath(from, to, from_source, [&](auto node) {
+            if(--steps == 0) {
+                middle = node;
+                return false;
+            }
+            return true;
+        });
+
+        return middle;
+    }
+
+    template<class Slice>
+    [[nodiscard]] auto findBestScoringNode(graph::Node from,
+                                           graph::Node to,
+                                           const Slice& from_source) const noexcept
+        -> std::optional<graph::Node>
+    {
+        const auto& scores = scores_.value();
+        auto best = to;
+
+        auto walkable = walkPath(from, to, from_source, [&](auto node) {
+            if(scores[node] >= scores[best]) {
+                best = node;
+            }
+            return true;
+        });
+
+        if(!walkable) {
+            return std::nullopt;
+        }
+
+        return best;
+    }
+
+    // calls the visitor for every node before the target on the path, down to
+    // and including the source, until the visitor returns false. Returns false
+    // if the distances do not describe a path through the graph
+    template<class Slice, class Visitor>
+    [[nodiscard]] auto walkPath(graph::Node from,
+                                graph::Node to,
+                                const Slice& from_source,
+                                Visitor&& visit) const noexcept
+        -> bool
+    {
+        if constexpr(has_predecessors<DistanceOracle>::value) {
+            if(distance_oracle_.hasPredecessors()) {
+                return walkPredecessors(from, to, std::forward<Visitor>(visit));
+            }
+        }
+
+        return pathfinding::walkPathBackwards(graph_,
+                                              from,
+                                              to,
+                                              from_source,
+                                              std::forward<Visitor>(visit));
+    }
+
+    // the predecessors of the oracle form a shortest path tree of the
+    // source, the walk over them always ends at the source
+    template<class Visitor>
+    [[nodiscard]] auto walkPredecessors(graph::Node from,
+                                        graph::Node to,
+                                        Visitor&& visit) const noexcept
+        -> bool
+    {
+        auto current = to;
+        while(current != from) {
+            auto before = distance_oracle_.findPredecessor(from, current);
+            if(!before) {
+                return false;
+            }
+
+            current = before.value();
+
+            if(!visit(current)) {
+                return true;
+            }
+        }
+
+        return true;
+    }
+
+private:
+    const graph::Graph& graph_;
+    const DistanceOracle& distance_oracle_;
+    std::optional<std::vector<double>> scores_;
+};
+
+} // namespace selection
@@ -1,7 +1,6 @@
 #pragma once
 
 #include <cmath>
-#include <execution>
 #include <fmt/core.h>
 #include <graph/Graph.hpp>
 #include <pathfinding/DijkstraQueue.hpp>
@@ -9,6 +8,9 @@
 #include <pathfinding/Path.hpp>
 #include <queue>
 #include <selection/NodeSelection.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
 #include <utils/Range.hpp>
 #include <vector>
 
@@ -18,15 +20,23 @@ template<class PathFinder>
 class PageRankCenterCalculator
 {
 public:
-    PageRankCenterCalculator(const graph::Graph& graph, std::size_t iterations)
+    static constexpr auto DAMPING_FACTOR = 0.85;
+    static constexpr auto DEFAULT_TOLERANCE = 1e-6;
+
+    // iterates until the L1 distance of two consecutive rank vectors, relative
+    // to the number of nodes, drops below the tolerance or until max_iterations
+    PageRankCenterCalculator(const graph::Graph& graph,
+                             std::size_t max_iterations,
+                             double tolerance = DEFAULT_TOLERANCE)
+        : PageRankCenterCalculator(graph, max_iterations, PathFinder{graph}, tolerance) {}
+
+    PageRankCenterCalculator(const graph::Graph& graph,
+                             std::size_t max_iterations,
+                             PathFinder path_finder,
+                             double tolerance = DEFAULT_TOLERANCE)
         : graph_(graph),
-          path_finder_(graph_),
-          pr_(graph_.size(), 0.0)
-    {
-        for(auto i = 0ul; i < iterations; i++) {
-            pr_ = pageRankIteration();
-        }
-    }
+          path_finder_(path_finder),
+          pr_(calculatePageRank(max_iterations, tolerance)) {}
 
     auto calculateCenter(graph::Node from, graph::Node to) noexcept
         -> std::optional<graph::Node>
@@ -41,42 +51,73 @@ public:
     }
 
 private:
-    auto pageRankIteration() noexcept
+    // pull based power iteration: the rank of a node is gathered from its
+    // forward neighbours, each contributing its rank divided by its number of
+    // backward neighbours. The divisions are replaced by precomputed inverse
+    // degrees and the ranks are scaled once per iteration, such that the inner
+    // loop is a plain gather and sum over a flat array of neighbour ids
+    [[nodiscard]] auto calculatePageRank(std::size_t max_iterations,
+                                         double tolerance) const noexcept
         -> std::vector<double>
     {
-        auto dumping_factor = 0.85;
-
-        std::vector page_rank(graph_.size(), 0.0);
-
-        auto nodes = utils::range(graph_.size());
-
-        std::transform(std::execution::par_unseq,
-                       std::begin(nodes),
-                       std::end(nodes),
-                       std::begin(page_rank),
-                       [&](auto current_node) {
-                           return pageRankUpdate(current_node, dumping_factor);
-                       });
-
-        return page_rank;
-    }
+        const auto graph_size = graph_.size();
+
+        std::vector<std::size_t> offsets(graph_size + 1, 0);
+        std::vector<std::uint32_t> neighbours;
+        std::vector<double> inverse_degree(graph_size, 0.0);
+
+        for(graph::Node n = 0; n < graph_size; n++) {
+            for(auto [neig, _] : graph_.getForwardNeigboursOf(n)) {
+                neighbours.emplace_back(neig);
+            }
+            offsets[n + 1] = neighbours.size();
+
+            const auto degree = graph_.getBackwardNeigboursOf(n).size();
+            if(degree > 0) {
+                inverse_degree[n] = 1.0 / static_cast<double>(degree);
+            }
+        }
 
-    auto pageRankUpdate(graph::Node n, double dumping_factor) noexcept
-        -> double
-    {
-        auto out_neigs = graph_.getForwardNeigboursOf(n);
-        auto sum = std::transform_reduce(
-            std::execution::par_unseq,
-            std::begin(out_neigs),
-            std::end(out_neigs),
-            0.0,
-            std::plus<>(),
-            [&](auto pair) {
-                auto [neig, _] = pair;
-                return pr_[neig] / graph_.getBackwardNeigboursOf(neig).size();
-            });
+        //the initial ranks of the fixed iteration count version were zero
+        std::vector<double> current(graph_size, 0.0);
+        std::vector<double> next(graph_size, 0.0);
+        std::vector<double> scaled(graph_size, 0.0);
+
+        for(std::size_t i = 0; i < max_iterations; i++) {
+            tbb::parallel_for(
+                tbb::blocked_range<graph::Node>(0, graph_size),
+                [&](const auto& range) {
+                    for(auto n = range.begin(); n != range.end(); n++) {
+                        scaled[n] = current[n] * inverse_degree[n];
+                    }
+                });
+
+            const auto residual = tbb::parallel_reduce(
+                tbb::blocked_range<graph::Node>(0, graph_size),
+                0.0,
+                [&](const auto& range, double partial_residual) {
+                    for(auto n = range.begin(); n != range.end(); n++) {
+                        double sum = 0.0;
+                        for(auto e = offsets[n]; e < offsets[n + 1]; e++) {
+                            sum += scaled[neighbours[e]];
+                        }
+
+                        next[n] = (1 - DAMPING_FACTOR) + DAMPING_FACTOR * sum;
+                        partial_residual += std::abs(next[n] - current[n]);
+                    }
+
+                    return partial_residual;
+                },
+                std::plus<>{});
+
+            std::swap(current, next);
+
+            if(residual < tolerance * static_cast<double>(graph_size)) {
+                break;
+            }
+        }
 
-        return (1 - dumping_factor) + dumping_factor * sum;
+        return current;
     }
 
     auto getPath(graph::Node from, graph::Node to) noexcept
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <fmt/core.h>
+#include <graph/Graph.hpp>
+#include <mutex>
+#include <optional>
+#include <pathfinding/Distance.hpp>
+#include <pathfinding/OneToAllDijkstra.hpp>
+#include <pathfinding/Path.hpp>
+#include <progresscpp/ProgressBar.hpp>
+#include <random>
+#include <selection/NodeSelection.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <utils/Range.hpp>
+#include <vector>
+
+namespace selection {
+
+enum class Centrality {
+    // number of nodes divided by the sum of the distances to a node,
+    // unreachable sources are left out of the sum
+    CLOSENESS,
+    // sum of the inverse distances to a node, unreachable sources
+    // contribute nothing, which keeps it well defined on any graph
+    HARMONIC
+};
+
+// approximates the closeness or harmonic centrality like Eppstein and Wang:
+// one to all searches are run from k sampled sources only and the sums are
+// scaled by n / k. With k = log(n) / epsilon^2 the estimated average distance
+// to every node is within epsilon times the diameter with high probability.
+// Only the graph is needed, no distance oracle
+template<class PathFinder>
+class SampledCentralityCenterCalculator
+{
+public:
+    static constexpr auto DEFAULT_SEED = std::uint64_t{42};
+    static constexpr auto DEFAULT_EPSILON = 0.1;
+
+    SampledCentralityCenterCalculator(const graph::Graph& graph,
+                                      Centrality centrality,
+                                      double epsilon,
+                                      std::uint64_t seed = DEFAULT_SEED)
+        : SampledCentralityCenterCalculator(graph,
+                                            centrality,
+                                            epsilon,
+                                            PathFinder{graph},
+                                            seed) {}
+
+    SampledCentralityCenterCalculator(const graph::Graph& graph,
+                                      Centrality centrality,
+                                      double epsilon,
+                                      PathFinder path_finder,
+                                      std::uint64_t seed = DEFAULT_SEED)
+        : graph_(graph),
+          path_finder_(path_finder),
+          centrality_(estimateCentrality(centrality,
+                                         sampleSources(epsilon, seed))) {}
+
+    auto calculateCenter(graph::Node from, graph::Node to) noexcept
+        -> std::optional<graph::Node>
+    {
+        auto path_opt = getPath(from, to);
+        if(!path_opt) {
+            return std::nullopt;
+        }
+
+        auto path = std::move(path_opt.value());
+        return findCenter(path);
+    }
+
+    // the estimated centrality of every node
+    [[nodiscard]] auto getCentrality() const noexcept
+        -> const std::vector<double>&
+    {
+        return centrality_;
+    }
+
+private:
+    [[nodiscard]] auto sampleSources(double epsilon, std::uint64_t seed) const noexcept
+        -> std::vector<graph::Node>
+    {
+        const auto graph_size = graph_.size();
+        const auto log_n = std::log(static_cast<double>(std::max<std::size_t>(2, graph_size)));
+        const auto number_of_samples = std::min<std::size_t>(
+            graph_size,
+            static_cast<std::size_t>(std::ceil(log_n / (epsilon * epsilon))));
+
+        std::vector<graph::Node> samples;
+        samples.reserve(number_of_samples);
+
+        auto nodes = utils::range(graph_size);
+        std::sample(std::begin(nodes),
+                    std::end(nodes),
+                    std::back_inserter(samples),
+                    number_of_samples,
+                    std::mt19937_64{seed});
+
+        return samples;
+    }
+
+    [[nodiscard]] auto estimateCentrality(Centrality centrality,
+                                          const std::vector<graph::Node>& samples) const noexcept
+        -> std::vector<double>
+    {
+        const auto graph_size = graph_.size();
+
+        tbb::enumerable_thread_specific<pathfinding::OneToAllDijkstra> searches{
+            [&] {
+                return pathfinding::OneToAllDijkstra{graph_};
+            }};
+
+        tbb::enumerable_thread_specific<std::vector<double>> local_sums{
+            [&] {
+                return std::vector<double>(graph_size, 0.0);
+            }};
+
+        progresscpp::ProgressBar bar{samples.size(), 80ul};
+        std::mutex bar_mutex;
+
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(0, samples.size()),
+            [&](const auto& range) {
+                auto& search = searches.local();
+                auto& sums = local_sums.local();
+
+                for(auto i = range.begin(); i != range.end(); i++) {
+                    const auto source = samples[i];
+                    const auto& distances = search.computeDistancesFrom(source);
+
+                    for(graph::Node n = 0; n < graph_size; n++) {
+                        const auto distance = distances[n];
+                        if(distance == graph::UNREACHABLE or n == source) {
+                            continue;
+                        }
+
+                        if(centrality == Centrality::CLOSENESS) {
+                            sums[n] += static_cast<double>(distance);
+                        } else if(distance > 0) {
+                            sums[n] += 1.0 / static_cast<double>(distance);
+                        }
+                    }
+
+                    std::lock_guard lock{bar_mutex};
+                    bar++;
+                    bar.displayIfChangedAtLeast(0.01);
+                }
+            });
+
+        bar.done();
+
+        std::vector<double> estimate(graph_size, 0.0);
+        for(const auto& sums : local_sums) {
+            std::transform(std::begin(sums),
+                           std::end(sums),
+                           std::begin(estimate),
+                           std::begin(estimate),
+                           std::plus<>{});
+        }
+
+        const auto scale = static_cast<double>(graph_size)
+            / static_cast<double>(std::max<std::size_t>(1, samples.size()));
+
+        std::transform(std::begin(estimate),
+                       std::end(estimate),
+                       std::begin(estimate),
+                       [&](auto sum) {
+                           if(centrality == Centrality::HARMONIC) {
+                               return sum * scale;
+                           }
+
+                           //no sampled source reaches the node, or only over
+                           //zero weight edges, the sum of distances is never negative
+                           if(sum <= 0.0) {
+                               return 0.0;
+                           }
+
+                           return static_cast<double>(graph_size) / (sum * scale);
+                       });
+
+        return estimate;
+    }
+
+    auto getPath(graph::Node from, graph::Node to) noexcept
+        -> std::optional<pathfinding::Path>
+    {
+        return path_finder_.findRoute(from, to);
+    }
+
+    auto findCenter(const pathfinding::Path& path) const noexcept
+        -> std::optional<graph::Node>
+    {
+        if(path.empty()) {
+            return std::nullopt;
+        }
+
+        const auto& nodes = path.getNodes();
+
+        return *std::max_element(
+            std::begin(nodes),
+            std::end(nodes),
+            [&](auto lhs, auto rhs) {
+                return centrality_[lhs] < centrality_[rhs];
+            });
+    }
+
+private:
+    const graph::Graph& graph_;
+    PathFinder path_finder_;
+    std::vector<double> centrality_;
+};
+
+} // namespace selection
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <graph/Graph.hpp>
+#include <mutex>
+#include <optional>
+#include <pathfinding/Distance.hpp>
+#include <selection/SelectionStore.hpp>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace selection {
+
+// everything which is needed to continue a calculation. The coverage is not
+// stored, it is rebuilt by covering the selections and the pairs which were
+// covered without a selection
+struct SelectionCheckpoint
+{
+    SelectionStore selections;
+    std::vector<std::pair<graph::Node, graph::Node>> covered_pairs;
+    std::string random_state;
+};
+
+// writes checkpoints of a selection calculation in a background thread. The
+// selections and the pairs covered without one are encoded as records when
+// they are added and only kept until the next checkpoint, taking a checkpoint
+// only copies the random state. The records of the earlier checkpoints are
+// copied from the previous file, such that no encoded copy of all of them is
+// held in memory. The file is written next to its final path, synced and
+// renamed, an interrupted write keeps the previous checkpoint. A checkpoint
+// which is still waiting when the next one is taken is replaced by it and its
+// records are written with the next one
+class CheckpointWriter
+{
+public:
+    CheckpointWriter(std::string path,
+                     std::uint64_t fingerprint,
+                     std::size_t number_of_nodes,
+                     graph::Distance prune_distance) noexcept;
+
+    // waits until the last checkpoint is written
+    ~CheckpointWriter() noexcept;
+
+    CheckpointWriter() = delete;
+    CheckpointWriter(CheckpointWriter&&) = delete;
+    CheckpointWriter(const CheckpointWriter&) = delete;
+    auto operator=(const CheckpointWriter&) -> CheckpointWriter& = delete;
+    auto operator=(CheckpointWriter&&) -> CheckpointWriter& = delete;
+
+    auto addSelection(const SelectionView& selection) noexcept
+        -> void;
+
+    // a seed pair which was covered without growing a selection
+    auto addCoveredPair(graph::Node first, graph::Node second) noexcept
+        -> void;
+
+    auto takeCheckpoint(std::string_view random_state) noexcept
+        -> void;
+
+private:
+    auto writeInBackground() noexcept
+        -> void;
+
+    // writes the header and the random state followed by the records of the
+    // previous file and the new ones
+    auto writeFile(const std::vector<char>& state,
+                   const std::vector<char>& new_records) const noexcept
+        -> bool;
+
+private:
+    struct PendingCheckpoint
+    {
+        std::vector<char> state;
+        std::vector<char> new_records;
+    };
+
+    std::string path_;
+    std::uint64_t fingerprint_;
+    std::size_t number_of_nodes_;
+    graph::Distance prune_distance_;
+
+    //the records added since the last checkpoint was taken
+    std::vector<char> new_records_;
+    std::size_t number_of_records_ = 0;
+
+    std::mutex mutex_;
+    std::condition_variable wake_up_;
+    std::optional<PendingCheckpoint> pending_;
+    bool stopping_ = false;
+
+    //only used by the background thread, the records which are not in
+    //a written file yet and where the ones of the last written file start
+    std::vector<char> unwritten_records_;
+    std::size_t written_records_offset_ = 0;
+    std::size_t written_records_size_ = 0;
+
+    //started last, after everything it uses is initialised
+    std::thread writer_;
+};
+
+// reads a checkpoint written by a CheckpointWriter, returns nothing if the
+// file does not exist, is damaged or was written for another graph or
+// prune distance
+[[nodiscard]] auto loadCheckpoint(std::string_view path,
+                                  std::uint64_t fingerprint,
+                                  std::size_t number_of_nodes,
+                                  graph::Distance prune_distance) noexcept
+    -> std::optional<SelectionCheckpoint>;
+
+} // namespace selection
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <graph/Graph.hpp>
+#include <memory>
+#include <optional>
+#include <pathfinding/Distance.hpp>
+#include <selection/NodeSelection.hpp>
+#include <selection/SelectionStore.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace selection {
+
+// writes selections one by one into a single binary file. The file starts
+// with a header page, followed by the patches of every selection, the nodes
+// of both patches first and their distances after them. The table with the
+// center and the patch offsets of every selection is appended by finish,
+// which fills in the header and moves the file to its path
+class SelectionFileWriter
+{
+public:
+    SelectionFileWriter(std::string path,
+                        std::uint64_t fingerprint,
+                        std::size_t number_of_nodes,
+                        graph::Distance prune_distance) noexcept;
+
+    // removes the file if it was not finished
+    ~SelectionFileWriter() noexcept;
+
+    SelectionFileWriter() = delete;
+    SelectionFileWriter(SelectionFileWriter&&) = delete;
+    SelectionFileWriter(const SelectionFileWriter&) = delete;
+    auto operator=(const SelectionFileWriter&) -> SelectionFileWriter& = delete;
+    auto operator=(SelectionFileWriter&&) -> SelectionFileWriter& = delete;
+
+    auto add(const SelectionView& selection) noexcept
+        -> void;
+
+    auto add(const NodeSelection& selection) noexcept
+        -> void;
+
+    [[nodiscard]] auto finish() noexcept
+        -> bool;
+
+private:
+    template<class SourcePatch, class TargetPatch>
+    auto add(const SourcePatch& sources,
+             const TargetPatch& targets,
+             graph::Node center,
+             bool is_inverse_valid) noexcept
+        -> void;
+
+    auto write(const char* bytes, std::size_t size) noexcept
+        -> void;
+
+private:
+    std::string path_;
+    std::string tmp_path_;
+    std::ofstream file_;
+    std::uint64_t fingerprint_;
+    std::size_t number_of_nodes_;
+    graph::Distance prune_distance_;
+    std::uint64_t position_ = 0;
+    std::size_t number_of_selections_ = 0;
+    std::vector<char> table_;
+    std::vector<std::uint32_t> nodes_;
+    std::vector<graph::Distance> distances_;
+    bool finished_ = false;
+};
+
+// the selections of a file written by a SelectionFileWriter. The file is
+// mapped read-only and the selections are views into the mapping, nothing
+// is copied. The node ids are checked when the file is opened, the
+// distances of a patch are only paged in once they are read
+class SelectionFile
+{
+public:
+    // returns nothing if the file does not exist or was written
+    // for another graph or prune distance
+    [[nodiscard]] static auto open(std::string_view path,
+                                   std::uint64_t fingerprint,
+                                   std::size_t number_of_nodes,
+                                   graph::Distance prune_distance) noexcept
+        -> std::optional<SelectionFile>;
+
+    SelectionFile() = delete;
+    SelectionFile(SelectionFile&&) = default;
+    SelectionFile(const SelectionFile&) = delete;
+    auto operator=(const SelectionFile&) -> SelectionFile& = delete;
+    auto operator=(SelectionFile&&) -> SelectionFile& = default;
+
+    [[nodiscard]] auto operator[](std::size_t index) const noexcept
+        -> SelectionView;
+
+    [[nodiscard]] auto size() const noexcept
+        -> std::size_t;
+
+    [[nodiscard]] auto empty() const noexcept
+        -> bool;
+
+private:
+    struct MappingDelete
+    {
+        std::size_t mapped_bytes = 0;
+
+        auto operator()(const char* mapping) const noexcept
+            -> void;
+    };
+
+    SelectionFile(const char* mapping,
+                  std::size_t mapped_bytes,
+                  std::size_t number_of_selections,
+                  std::size_t table_offset) noexcept;
+
+private:
+    std::unique_ptr<const char[], MappingDelete> mapping_;
+    std::size_t number_of_selections_;
+    std::size_t table_offset_;
+};
+
+} // namespace selection
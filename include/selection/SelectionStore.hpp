@@ -0,0 +1,251 @@
+#pragma once
+
+#include <cstdint>
+#include <graph/Graph.hpp>
+#include <iterator>
+#include <pathfinding/Distance.hpp>
+#include <selection/NodeSelection.hpp>
+#include <utility>
+#include <vector>
+
+namespace selection {
+
+// a patch inside of a SelectionStore. The nodes and the distances are read
+// from two separate arrays, every entry is returned as a pair like the entries
+// of a Patch, such that both can be iterated the same way
+class PatchView
+{
+public:
+    class Iterator
+    {
+    public:
+        using difference_type = std::ptrdiff_t;
+        using value_type = std::pair<graph::Node, graph::Distance>;
+        using pointer = void;
+        using reference = value_type;
+        using iterator_category = std::input_iterator_tag;
+
+        Iterator(const std::uint32_t* node,
+                 const graph::Distance* distance) noexcept
+            : node_(node),
+              distance_(distance) {}
+
+        auto operator*() const noexcept
+            -> value_type
+        {
+            return std::pair{static_cast<graph::Node>(*node_),
+                             *distance_};
+        }
+
+        auto operator++() noexcept
+            -> Iterator&
+        {
+            node_++;
+            distance_++;
+            return *this;
+        }
+
+        auto operator==(const Iterator& other) const noexcept
+            -> bool
+        {
+            return node_ == other.node_;
+        }
+
+        auto operator!=(const Iterator& other) const noexcept
+            -> bool
+        {
+            return node_ != other.node_;
+        }
+
+    private:
+        const std::uint32_t* node_;
+        const graph::Distance* distance_;
+    };
+
+    PatchView(const std::uint32_t* nodes,
+              const graph::Distance* distances,
+              std::size_t size) noexcept
+        : nodes_(nodes),
+          distances_(distances),
+          size_(size) {}
+
+    auto operator[](std::size_t index) const noexcept
+        -> std::pair<graph::Node, graph::Distance>
+    {
+        return std::pair{static_cast<graph::Node>(nodes_[index]),
+                         distances_[index]};
+    }
+
+    [[nodiscard]] auto size() const noexcept
+        -> std::size_t
+    {
+        return size_;
+    }
+
+    [[nodiscard]] auto empty() const noexcept
+        -> bool
+    {
+        return size_ == 0;
+    }
+
+    [[nodiscard]] auto begin() const noexcept
+        -> Iterator
+    {
+        return Iterator{nodes_, distances_};
+    }
+
+    [[nodiscard]] auto end() const noexcept
+        -> Iterator
+    {
+        return Iterator{nodes_ + size_, distances_ + size_};
+    }
+
+private:
+    const std::uint32_t* nodes_;
+    const graph::Distance* distances_;
+    std::size_t size_;
+};
+
+// a selection inside of a SelectionStore, valid until the store grows
+class SelectionView
+{
+public:
+    SelectionView(PatchView source_patch,
+                  PatchView target_patch,
+                  graph::Node center,
+                  bool is_inverse_valid) noexcept
+        : source_patch_(source_patch),
+          target_patch_(target_patch),
+          center_(center),
+          is_inverse_valid_(is_inverse_valid) {}
+
+    [[nodiscard]] auto getSourcePatch() const noexcept
+        -> PatchView
+    {
+        return source_patch_;
+    }
+
+    [[nodiscard]] auto getTargetPatch() const noexcept
+        -> PatchView
+    {
+        return target_patch_;
+    }
+
+    [[nodiscard]] auto getCenter() const noexcept
+        -> graph::Node
+    {
+        return center_;
+    }
+
+    [[nodiscard]] auto isInverseValid() const noexcept
+        -> bool
+    {
+        return is_inverse_valid_;
+    }
+
+    [[nodiscard]] auto weight() const noexcept
+        -> std::size_t
+    {
+        return source_patch_.size() * target_patch_.size();
+    }
+
+    // copies the selection out of the store
+    [[nodiscard]] auto toNodeSelection() const noexcept
+        -> NodeSelection;
+
+private:
+    PatchView source_patch_;
+    PatchView target_patch_;
+    graph::Node center_;
+    bool is_inverse_valid_;
+};
+
+// keeps the patches of many selections in two arrays, one with the nodes and
+// one with the distances. The nodes have 32 bit entries. The distances stay
+// graph::Distance wide, although the MatrixEntry of the matrix oracles would
+// hold them: the views hand out pointers into the array and the compressed
+// oracle does not bound its distances. A selection is an offset into the
+// arrays, adding one only appends to them and their capacity is kept when
+// the store is cleared
+class SelectionStore
+{
+public:
+    SelectionStore() = default;
+    SelectionStore(SelectionStore&&) = default;
+    SelectionStore(const SelectionStore&) = delete;
+    auto operator=(const SelectionStore&) -> SelectionStore& = delete;
+    auto operator=(SelectionStore&&) -> SelectionStore& = default;
+
+    template<class SourcePatch, class TargetPatch>
+    auto add(const SourcePatch& sources,
+             const TargetPatch& targets,
+             graph::Node center,
+             bool is_inverse_valid) noexcept
+        -> void
+    {
+        records_.push_back(Record{nodes_.size(),
+                                  static_cast<std::uint32_t>(sources.size()),
+                                  static_cast<std::uint32_t>(targets.size()),
+                                  static_cast<std::uint32_t>(center),
+                                  is_inverse_valid});
+
+        appendPatch(sources);
+        appendPatch(targets);
+    }
+
+    auto add(const SelectionView& selection) noexcept
+        -> void;
+
+    auto add(const NodeSelection& selection) noexcept
+        -> void;
+
+    auto removeLast() noexcept
+        -> void;
+
+    auto clear() noexcept
+        -> void;
+
+    [[nodiscard]] auto operator[](std::size_t index) const noexcept
+        -> SelectionView;
+
+    [[nodiscard]] auto back() const noexcept
+        -> SelectionView;
+
+    [[nodiscard]] auto size() const noexcept
+        -> std::size_t;
+
+    [[nodiscard]] auto empty() const noexcept
+        -> bool;
+
+    // copies the selections in the given order into a store which is exactly
+    // as large as needed, selections which are not in the order are dropped
+    [[nodiscard]] auto compacted(const std::vector<std::size_t>& order) const noexcept
+        -> SelectionStore;
+
+private:
+    struct Record
+    {
+        std::size_t begin;
+        std::uint32_t number_of_sources;
+        std::uint32_t number_of_targets;
+        std::uint32_t center;
+        bool is_inverse_valid;
+    };
+
+    template<class PatchRange>
+    auto appendPatch(const PatchRange& patch) noexcept
+        -> void
+    {
+        for(auto [node, distance] : patch) {
+            nodes_.emplace_back(static_cast<std::uint32_t>(node));
+            distances_.emplace_back(distance);
+        }
+    }
+
+private:
+    std::vector<std::uint32_t> nodes_;
+    std::vector<graph::Distance> distances_;
+    std::vector<Record> records_;
+};
+
+} // namespace selection
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace utils {
+
+// prefix sums over non negative counts which can be updated in O(log n)
+class FenwickTree
+{
+public:
+    explicit FenwickTree(std::size_t size)
+        : tree_(size + 1, 0)
+    {
+        //highest power of two which is not larger than the size
+        while(top_bit_ * 2 <= size) {
+            top_bit_ *= 2;
+        }
+    }
+
+    auto add(std::size_t index, long long delta) noexcept
+        -> void
+    {
+        for(auto i = index + 1; i < tree_.size(); i += i & (~i + 1)) {
+            tree_[i] += delta;
+        }
+    }
+
+    // sum of the counts at the indices [0, index)
+    [[nodiscard]] auto prefixSum(std::size_t index) const noexcept
+        -> long long
+    {
+        long long sum = 0;
+        for(auto i = index; i > 0; i -= i & (~i + 1)) {
+            sum += tree_[i];
+        }
+        return sum;
+    }
+
+    // the index which holds the k-th unit of all counts, counting from 0,
+    // which is the smallest index with prefixSum(index + 1) > k
+    [[nodiscard]] auto find(long long k) const noexcept
+        -> std::size_t
+    {
+        std::size_t index = 0;
+        for(auto bit = top_bit_; bit > 0; bit /= 2) {
+            auto next = index + bit;
+            if(next < tree_.size() and tree_[next] <= k) {
+                index = next;
+                k -= tree_[next];
+            }
+        }
+        return index;
+    }
+
+private:
+    std::vector<long long> tree_;
+    std::size_t top_bit_ = 1;
+};
+
+} // namespace utils
@@ -8,13 +8,49 @@
 
 namespace utils {
 
+// how the center of the shortest path between a seed pair is chosen
+enum class CenterChoice {
+    // the middle node of the path found by a dijkstra search
+    MIDDLE,
+    // the middle node of the path walked back through the distance oracle
+    ORACLE,
+    // the node on the dijkstra path with the highest closeness centrality
+    CLOSENESS,
+    // like CLOSENESS, but estimated from the searches of sampled sources
+    SAMPLED_CLOSENESS,
+    // the node with the highest harmonic centrality estimated from samples
+    SAMPLED_HARMONIC,
+    // the node on the dijkstra path with the highest betweenness centrality
+    BETWEENNESS
+};
+
 class ProgramOptions
 {
 public:
     ProgramOptions(graph::Distance prune_distance,
                    std::string graph_file,
                    std::size_t maximum_number_of_selections_per_node,
-                   std::optional<std::string> result_folder = std::nullopt);
+                   std::optional<std::string> result_folder = std::nullopt,
+                   std::optional<std::string> cache_folder = std::nullopt,
+                   bool compress_distances = false,
+                   bool transposed_copy = false,
+                   std::optional<std::size_t> lazy_cache_budget = std::nullopt,
+                   bool record_predecessors = false,
+                   std::optional<std::size_t> candidate_failure_limit = std::nullopt,
+                   std::optional<graph::Distance> candidate_radius = std::nullopt,
+                   std::optional<std::uint64_t> seed = std::nullopt,
+                   bool parallel_selection = false,
+                   bool farthest_first = false,
+                   CenterChoice center_choice = CenterChoice::MIDDLE,
+                   std::optional<std::size_t> checkpoint_interval = std::nullopt,
+                   bool resume = false,
+                   std::optional<std::string> selections_to_save = std::nullopt,
+                   std::optional<std::string> selections_to_load = std::nullopt,
+                   std::optional<std::string> geojson_file = std::nullopt,
+                   bool geojson_lines = false,
+                   std::optional<int> geojson_decimals = std::nullopt,
+                   std::optional<std::size_t> geojson_limit = std::nullopt,
+                   bool verify_answers = false);
 
     auto getGraphFile() const noexcept
         -> std::string_view;
@@ -25,6 +61,100 @@ public:
     auto getResultFolder() const noexcept
         -> std::string_view;
 
+    auto hasCacheFolder() const noexcept
+        -> bool;
+
+    auto getCacheFolder() const noexcept
+        -> std::string_view;
+
+    auto compressDistances() const noexcept
+        -> bool;
+
+    auto keepTransposedCopy() const noexcept
+        -> bool;
+
+    auto recordPredecessors() const noexcept
+        -> bool;
+
+    auto hasLazyCacheBudget() const noexcept
+        -> bool;
+
+    // memory budget of the lazy row cache in bytes
+    auto getLazyCacheBudget() const noexcept
+        -> std::size_t;
+
+    // number of rejected candidates in a row after which a selection stops growing
+    auto getCandidateFailureLimit() const noexcept
+        -> std::optional<std::size_t>;
+
+    // maximum distance of a candidate from the center of its selection
+    auto getCandidateRadius() const noexcept
+        -> std::optional<graph::Distance>;
+
+    // grow the selections of several seed pairs at once
+    auto selectInParallel() const noexcept
+        -> bool;
+
+    // start the selections at the farthest uncovered pairs instead of random ones
+    auto seedFarthestFirst() const noexcept
+        -> bool;
+
+    // how the centers of the selections are chosen
+    auto getCenterChoice() const noexcept
+        -> CenterChoice;
+
+    // seconds between two checkpoints of the selection calculation
+    auto getCheckpointInterval() const noexcept
+        -> std::optional<std::size_t>;
+
+    // continue the selection calculation from the last checkpoint
+    auto resume() const noexcept
+        -> bool;
+
+    auto hasSelectionsToSave() const noexcept
+        -> bool;
+
+    // file into which the calculated selections are written
+    auto getSelectionsToSave() const noexcept
+        -> std::string_view;
+
+    auto hasSelectionsToLoad() const noexcept
+        -> bool;
+
+    // file from which the selections are read instead of calculating them
+    auto getSelectionsToLoad() const noexcept
+        -> std::string_view;
+
+    auto hasGeoJsonFile() const noexcept
+        -> bool;
+
+    // file into which the selections are exported for viewers
+    auto getGeoJsonFile() const noexcept
+        -> std::string_view;
+
+    // export one feature per line instead of a single FeatureCollection
+    auto geoJsonLines() const noexcept
+        -> bool;
+
+    // number of decimals of the exported coordinates
+    auto getGeoJsonDecimals() const noexcept
+        -> std::optional<int>;
+
+    // number of heaviest selections which are exported
+    auto getGeoJsonLimit() const noexcept
+        -> std::optional<std::size_t>;
+
+    // check every answered query against dijkstra and print the wrong answers
+    auto verifyAnswers() const noexcept
+        -> bool;
+
+    auto hasSeed() const noexcept
+        -> bool;
+
+    // seed of the random choices while the selections are calculated
+    auto getSeed() const noexcept
+        -> std::uint64_t;
+
     auto getPruneDistance() const noexcept
         -> graph::Distance;
 
@@ -36,6 +166,26 @@ private:
     std::string graph_file_;
     std::size_t maximum_number_of_selections_per_node_;
     std::optional<std::string> separation_folder_;
+    std::optional<std::string> cache_folder_;
+    bool compress_distances_;
+    bool transposed_copy_;
+    std::optional<std::size_t> lazy_cache_budget_;
+    bool record_predecessors_;
+    std::optional<std::size_t> candidate_failure_limit_;
+    std::optional<graph::Distance> candidate_radius_;
+    std::optional<std::uint64_t> seed_;
+    bool parallel_selection_;
+    bool farthest_first_;
+    CenterChoice center_choice_;
+    std::optional<std::size_t> checkpoint_interval_;
+    bool resume_;
+    std::optional<std::string> selections_to_save_;
+    std::optional<std::string> selections_to_load_;
+    std::optional<std::string> geojson_file_;
+    bool geojson_lines_;
+    std::optional<int> geojson_decimals_;
+    std::optional<std::size_t> geojson_limit_;
+    bool verify_answers_;
 };
 
 auto parseArguments(int argc, char* argv[])
@@ -6,6 +6,9 @@
 #include <future>
 #include <iomanip>
 #include <sstream>
+#include <string>
+#include <string_view>
+#include <unistd.h>
 #include <utility>
 #include <vector>
 
@@ -231,6 +234,14 @@ inline auto unquote(const std::string& s)
     return result;
 }
 
+// the file next to the path into which this process writes before renaming
+// it, the process id keeps concurrent runs from writing into the same file
+inline auto temporaryPathOf(std::string_view path) noexcept
+    -> std::string
+{
+    return fmt::format("{}.{}.tmp", path, getpid());
+}
+
 template<class... Ts>
 struct Overloaded : Ts...
 {
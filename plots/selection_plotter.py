@@ -4,36 +4,42 @@ import mplleaflet
 import argparse
 
 
-def load_sources_data(path):
+def load_features(path):
+    # the export is either one FeatureCollection or one feature per line
     with open(path, newline='') as f:
-        data = json.load(f)
-        print(data)
-        sources = data["source_coords"]
-        source_lngs = [x[1] for x in sources]
-        source_lats = [x[0] for x in sources]
-        return source_lngs, source_lats
+        first = f.readline()
+        if first.startswith('{"type":"FeatureCollection"'):
+            f.seek(0)
+            yield from json.load(f)["features"]
+            return
 
+        f.seek(0)
+        for line in f:
+            if line.strip():
+                yield json.loads(line)
 
-def load_targets_data(path):
-    with open(path, newline='') as f:
-        data = json.load(f)
-        targets = data["target_coords"]
-        target_lngs = [x[1] for x in targets]
-        target_lats = [x[0] for x in targets]
-        return target_lngs, target_lats
 
+def load_selection_data(path, selection):
+    points = {}
+    for feature in load_features(path):
+        properties = feature["properties"]
+        if properties["selection"] != selection:
+            continue
 
-def load_center_data(path):
-    with open(path, newline='') as f:
-        data = json.load(f)
-        center = data["center_coords"]
-        return [center[1]], [center[0]]
+        geometry = feature["geometry"]
+        coords = geometry["coordinates"]
+        if geometry["type"] == "Point":
+            coords = [coords]
+
+        points[properties["role"]] = ([x[0] for x in coords],
+                                      [x[1] for x in coords])
+
+    return points["sources"], points["targets"], points["center"]
 
 
-def plt_selection(infile, outfile):
-    src_lng, src_lat = load_sources_data(infile)
-    trg_lng, trg_lat = load_targets_data(infile)
-    center_lng, center_lat = load_center_data(infile)
+def plt_selection(infile, outfile, selection):
+    (src_lng, src_lat), (trg_lng, trg_lat), (center_lng, center_lat) = \
+        load_selection_data(infile, selection)
 
     # plt.hold(True)
     plt.plot(src_lng, src_lat, 'b.')
@@ -46,9 +52,10 @@ if __name__ == '__main__':
     parser = argparse.ArgumentParser(description='selection plotter')
     parser.add_argument('--file', '-f', required=True, type=str)
     parser.add_argument('--output', '-o', required=True, type=str)
+    parser.add_argument('--selection', '-s', default=0, type=int)
     args = parser.parse_args()
 
     infile = args.file
     outfile = args.output
 
-    plt_selection(infile, outfile)
+    plt_selection(infile, outfile, args.selection)
@@ -40,6 +40,33 @@ auto adjListToOffsetArray(std::vector<std::vector<std::pair<graph::Node, graph::
                      std::move(offset)};
 }
 
+// one step of FNV-1a which takes a whole 64 bit word instead of a byte
+constexpr auto hashWord(std::uint64_t hash, std::uint64_t word) noexcept
+    -> std::uint64_t
+{
+    return (hash ^ word) * 0x100000001b3ull;
+}
+
+// hash of the offset arrays of the forward edges, every offset, node and
+// distance is hashed as one word, such that no padding bytes are read
+auto hashForwardEdges(const std::vector<std::size_t>& offsets,
+                      const std::vector<std::pair<graph::Node, graph::Distance>>& neigbours) noexcept
+    -> std::uint64_t
+{
+    auto hash = 0xcbf29ce484222325ull;
+
+    for(auto offset : offsets) {
+        hash = hashWord(hash, offset);
+    }
+
+    for(auto [node, distance] : neigbours) {
+        hash = hashWord(hash, node);
+        hash = hashWord(hash, static_cast<std::uint64_t>(distance));
+    }
+
+    return hash;
+}
+
 auto reverseAdjList(const std::vector<std::vector<std::pair<graph::Node, graph::Distance>>>& adj_list)
     -> std::vector<std::vector<std::pair<graph::Node, graph::Distance>>>
 {
@@ -72,6 +99,8 @@ Graph::Graph(const std::vector<std::vector<std::pair<Node, Distance>>>& adj_list
     auto [backward_neigs, backward_offset] = adjListToOffsetArray(backward_adj_list);
     backward_neigbours_ = std::move(backward_neigs);
     backward_offset_ = std::move(backward_offset);
+
+    fingerprint_ = hashForwardEdges(forward_offset_, forward_neigbours_);
 }
 
 auto Graph::getForwardNeigboursOf(Node node) const noexcept
@@ -137,6 +166,11 @@ auto Graph::getLatLng(Node n) const noexcept
                      lngs_[n]};
 }
 
+auto Graph::fingerprint() const noexcept
+    -> std::uint64_t
+{
+    return fingerprint_;
+}
 
 auto graph::parseFMIFile(std::string_view path) noexcept
     -> std::optional<Graph>
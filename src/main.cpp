@@ -5,18 +5,30 @@
 #include <fstream>
 #include <graph/Graph.hpp>
 #include <pathfinding/CachingDijkstra.hpp>
+#include <pathfinding/CompressedCachingDijkstra.hpp>
+#include <pathfinding/LazyCachingDijkstra.hpp>
 #include <pathfinding/Dijkstra.hpp>
+#include <pathfinding/QueryScheduler.hpp>
+#include <random>
+#include <selection/BetweennessCenterCalculator.hpp>
 #include <selection/ClosenessCentralityCenterCalculator.hpp>
 #include <selection/FullNodeSelectionCalculator.hpp>
+#include <selection/GeoJsonExport.hpp>
 #include <selection/MiddleChoosingCenterCalculator.hpp>
+#include <selection/OracleCenterCalculator.hpp>
 #include <selection/PageRankCenterCalculator.hpp>
+#include <selection/SampledCentralityCenterCalculator.hpp>
+#include <selection/SelectionFile.hpp>
 #include <selection/SelectionLookup.hpp>
 #include <selection/SelectionOptimizer.hpp>
 #include <utils/ProgramOptions.hpp>
+#include <utils/Range.hpp>
 #include <utils/Timer.hpp>
 #include <utils/Utils.hpp>
 
 using pathfinding::CachingDijkstra;
+using pathfinding::CompressedCachingDijkstra;
+using pathfinding::LazyCachingDijkstra;
 using pathfinding::Dijkstra;
 using selection::NodeSelection;
 using selection::FullNodeSelectionCalculator;
@@ -56,10 +68,40 @@ auto createRankQueries(const graph::Graph &graph) noexcept
     return queries;
 }
 
+auto countWrongAnswers(const graph::Graph &graph,
+                       const selection::SelectionLookup &lookup,
+                       const std::vector<std::vector<std::pair<graph::Node, graph::Node>>> &queries) noexcept
+    -> std::size_t
+{
+    std::vector<pathfinding::Query> flat_queries;
+    for(const auto &rank_queries : queries) {
+        flat_queries.insert(std::end(flat_queries),
+                            std::begin(rank_queries),
+                            std::end(rank_queries));
+    }
+
+    // the queries are shuffled, the scheduler groups them by source
+    // such that only one dijkstra search is needed per source
+    Dijkstra dijkstra{graph};
+    pathfinding::QueryScheduler scheduler{dijkstra};
+    auto distances = scheduler.findDistances(flat_queries);
+
+    std::size_t wrong_answers = 0;
+    for(std::size_t i = 0; i < flat_queries.size(); i++) {
+        auto [from, to] = flat_queries[i];
+        if(lookup.getSelectionAnswering(from, to) != distances[i]) {
+            wrong_answers++;
+        }
+    }
+
+    return wrong_answers;
+}
+
 template<class DistanceOracle>
 auto queryAll(const graph::Graph &graph,
               DistanceOracle &oracle,
-              const selection::SelectionLookup &lookup) noexcept
+              const selection::SelectionLookup &lookup,
+              bool verify_answers) noexcept
     -> std::tuple<
         std::map<std::size_t, std::pair<double, std::size_t>>,
         std::map<std::size_t, std::pair<double, std::size_t>>,
@@ -112,6 +154,10 @@ auto queryAll(const graph::Graph &graph,
     }
     utils::cleanAndFree(all_queries);
 
+    //checking the answers runs a dijkstra search from every source
+    const auto wrong_answers = verify_answers
+        ? std::optional{countWrongAnswers(graph, lookup, found_queries)}
+        : std::nullopt;
 
     std::map<std::size_t, std::pair<double, std::size_t>>
         per_dijkstra_rank_found_runtime;
@@ -154,13 +200,19 @@ auto queryAll(const graph::Graph &graph,
 
 
 
-    fmt::print("{} \t {} \t {} \t {} \t {}\n",
+    fmt::print("{} \t {} \t {} \t {} \t {}",
                found_query_time / found,
                not_found_query_time / not_found,
                static_cast<double>(found) / static_cast<double>(not_found + found),
                static_cast<double>(all_found) / static_cast<double>(all_not_found + all_found),
                elapsed / (all_found + all_not_found));
 
+    //the wrong answers are appended, the columns before them stay the same
+    if(wrong_answers) {
+        fmt::print(" \t {}", wrong_answers.value());
+    }
+    fmt::print("\n");
+
     return std::tuple{per_dijkstra_rank_found_runtime,
                       per_dijkstra_rank_not_found_runtime,
                       per_dijkstra_rank_found};
@@ -258,77 +310,315 @@ auto writeToFiles(const graph::Graph &graph,
 }
 
 
-template<class DistanceOracle>
-auto runSelection(const graph::Graph &graph,
-                  DistanceOracle &distance_oracle,
-                  const std::string &result_folder,
-                  graph::Distance prune_distance,
-                  std::size_t max_selections)
+// everything a run needs besides the graph and the distance oracle
+struct SelectionSettings
 {
-    using CenterCalculator = selection::MiddleChoosingCenterCalculator<Dijkstra>;
-    using SelectionCalculator = FullNodeSelectionCalculator<CenterCalculator, DistanceOracle>;
+    std::string result_folder;
+    graph::Distance prune_distance;
+    std::size_t max_selections;
+    selection::CandidateLimits candidate_limits;
+    std::uint64_t seed;
+    selection::Seeding seeding;
+    bool parallel_selection;
+    utils::CenterChoice center_choice;
+    std::optional<std::string> cache_folder;
+    std::optional<std::size_t> checkpoint_interval;
+    bool resume;
+    std::optional<std::string> selections_to_save;
+    std::optional<std::string> selections_to_load;
+    std::optional<std::string> geojson_file;
+    selection::GeoJsonOptions geojson_options;
+    bool verify_answers;
+};
+
+auto selectionSettingsOf(const utils::ProgramOptions &options) noexcept
+    -> SelectionSettings
+{
+    //the getters of the optional paths may only be called if the path is given
+    const auto optionalPath = [&](auto has_path, auto get_path)
+        -> std::optional<std::string> {
+        if(!(options.*has_path)()) {
+            return std::nullopt;
+        }
+        return std::string{(options.*get_path)()};
+    };
+
+    //without a seed every run chooses other pairs, print it to be able to repeat the run
+    const auto seed = options.hasSeed()
+        ? options.getSeed()
+        : std::uint64_t{std::random_device{}()};
+    fmt::print(stderr, "seed: {}\n", seed);
+
+    const auto graph_filename = utils::unquote(fs::path(options.getGraphFile()).filename());
+
+    //the selections are sorted by weight, the geojson limit keeps the heaviest ones
+    return SelectionSettings{
+        fmt::format("./results/{}/", graph_filename),
+        options.getPruneDistance(),
+        options.getMaxNumberOfSelectionsPerNode(),
+        selection::CandidateLimits{options.getCandidateFailureLimit(),
+                                   options.getCandidateRadius()},
+        seed,
+        options.seedFarthestFirst()
+            ? selection::Seeding::FARTHEST_FIRST
+            : selection::Seeding::RANDOM,
+        options.selectInParallel(),
+        options.getCenterChoice(),
+        optionalPath(&utils::ProgramOptions::hasCacheFolder,
+                     &utils::ProgramOptions::getCacheFolder),
+        options.getCheckpointInterval(),
+        options.resume(),
+        optionalPath(&utils::ProgramOptions::hasSelectionsToSave,
+                     &utils::ProgramOptions::getSelectionsToSave),
+        optionalPath(&utils::ProgramOptions::hasSelectionsToLoad,
+                     &utils::ProgramOptions::getSelectionsToLoad),
+        optionalPath(&utils::ProgramOptions::hasGeoJsonFile,
+                     &utils::ProgramOptions::getGeoJsonFile),
+        selection::GeoJsonOptions{options.geoJsonLines()
+                                      ? selection::GeoJsonLayout::NEWLINE_DELIMITED
+                                      : selection::GeoJsonLayout::FEATURE_COLLECTION,
+                                  options.getGeoJsonDecimals(),
+                                  options.getGeoJsonLimit()},
+        options.verifyAnswers()};
+}
+
+// calls the function with the chosen center calculator, the oracle
+// calculator reads the centers from the oracle without a second search.
+// The closeness is reused from the cache folder if one is given, the
+// sampled centralities draw their sources with the seed of the run
+template<class DistanceOracle, class Function>
+auto withCenterCalculator(const graph::Graph &graph,
+                          DistanceOracle &distance_oracle,
+                          const SelectionSettings &settings,
+                          Function &&function)
+{
+    using ClosenessCalculator = selection::ClosenessCentralityCenterCalculator<Dijkstra, DistanceOracle>;
+    using SampledCalculator = selection::SampledCentralityCenterCalculator<Dijkstra>;
+
+    switch(settings.center_choice) {
+    case utils::CenterChoice::ORACLE:
+        return function(selection::OracleCenterCalculator<DistanceOracle>{graph, distance_oracle});
+    case utils::CenterChoice::CLOSENESS:
+        return function(ClosenessCalculator{graph, distance_oracle, settings.cache_folder});
+    case utils::CenterChoice::SAMPLED_CLOSENESS:
+        return function(SampledCalculator{graph,
+                                          selection::Centrality::CLOSENESS,
+                                          SampledCalculator::DEFAULT_EPSILON,
+                                          settings.seed});
+    case utils::CenterChoice::SAMPLED_HARMONIC:
+        return function(SampledCalculator{graph,
+                                          selection::Centrality::HARMONIC,
+                                          SampledCalculator::DEFAULT_EPSILON,
+                                          settings.seed});
+    case utils::CenterChoice::BETWEENNESS:
+        return function(selection::BetweennessCenterCalculator<Dijkstra>{graph});
+    case utils::CenterChoice::MIDDLE:
+    default:
+        return function(selection::MiddleChoosingCenterCalculator<Dijkstra>{graph});
+    }
+}
+
+// calls the function with the distance oracle chosen by the options, the
+// oracles are neither copied nor moved and are built in place. Returns false
+// if the distances of the graph do not fit into the chosen oracle
+template<class Function>
+[[nodiscard]] auto withDistanceOracle(const graph::Graph &graph,
+                                      const utils::ProgramOptions &options,
+                                      const SelectionSettings &settings,
+                                      Function &&function)
+    -> bool
+{
+    if(options.compressDistances()) {
+        CompressedCachingDijkstra distance_oracle{graph};
+        function(distance_oracle);
+        return true;
+    }
 
-    CenterCalculator center_calculator{graph};
+    //the other oracles keep the distances in matrix entries, which may be too narrow
+    if(!pathfinding::DistanceMatrix::canHoldDistancesOf(graph)) {
+        fmt::print(stderr,
+                   "the distances of the graph may not fit into {} bit matrix entries, "
+                   "rebuild with WIDE_DISTANCE_MATRIX enabled or compress them with -z\n",
+                   sizeof(pathfinding::MatrixEntry) * 8);
+        return false;
+    }
+
+    if(options.hasLazyCacheBudget()) {
+        LazyCachingDijkstra distance_oracle{graph, options.getLazyCacheBudget()};
+        function(distance_oracle);
+        return true;
+    }
+
+    CachingDijkstra distance_oracle{graph,
+                                    settings.cache_folder,
+                                    options.keepTransposedCopy(),
+                                    options.recordPredecessors()};
+    function(distance_oracle);
+    return true;
+}
+
+template<class DistanceOracle, class CenterCalculator>
+auto calculateSelections(const graph::Graph &graph,
+                         DistanceOracle &distance_oracle,
+                         CenterCalculator center_calculator,
+                         const SelectionSettings &settings)
+    -> selection::SelectionStore
+{
+    using SelectionCalculator = FullNodeSelectionCalculator<CenterCalculator, DistanceOracle>;
 
     SelectionCalculator selection_calculator{graph,
                                              distance_oracle,
                                              std::move(center_calculator),
-                                             prune_distance};
+                                             settings.prune_distance,
+                                             settings.candidate_limits,
+                                             settings.seed,
+                                             settings.seeding};
+
+    const auto checkpoint_path = settings.result_folder + "selections.checkpoint";
+    if(settings.resume and !selection_calculator.resumeFrom(checkpoint_path)) {
+        fmt::print(stderr, "unable to resume from {}, starting from scratch\n", checkpoint_path);
+    }
+
+    if(settings.checkpoint_interval) {
+        selection_calculator.checkpointTo(checkpoint_path,
+                                          std::chrono::seconds{settings.checkpoint_interval.value()});
+    }
 
     utils::Timer t;
 
     t.reset();
-    auto selections = selection_calculator.calculateFullNodeSelection();
+    auto selections = settings.parallel_selection
+        ? selection_calculator.calculateFullNodeSelectionInParallel()
+        : selection_calculator.calculateFullNodeSelection();
+
     auto time = t.elapsed();
     fmt::print("{} \t ", time);
 
-    std::sort(std::rbegin(selections),
-              std::rend(selections),
-              [](const auto &lhs, const auto &rhs) {
-                  return lhs.weight() < rhs.weight();
+    //the heaviest selections first, the store is compacted in that order
+    auto indices = utils::range(selections.size());
+    std::vector<std::size_t> order(std::begin(indices), std::end(indices));
+    std::sort(std::rbegin(order),
+              std::rend(order),
+              [&](auto lhs, auto rhs) {
+                  return selections[lhs].weight() < selections[rhs].weight();
               });
 
-    // writeToFiles(graph, result_folder, selections);
+    return selections.compacted(order);
+}
 
-    t.reset();
+template<class DistanceOracle, class Selections>
+auto optimizeSelections(const graph::Graph &graph,
+                        DistanceOracle &distance_oracle,
+                        const SelectionSettings &settings,
+                        Selections selections)
+{
+    utils::Timer t;
     selection::SelectionOptimizer optimizer{graph.size(),
                                             std::move(selections),
                                             distance_oracle,
-                                            prune_distance,
-                                            max_selections};
+                                            settings.prune_distance,
+                                            settings.max_selections};
     optimizer.optimize();
 
     auto lookup = std::move(optimizer).getLookup();
 
-    time = t.elapsed();
+    const auto time = t.elapsed();
     fmt::print("{} \t {} \t ", time, lookup.averageSelectionsPerNode());
 
-    auto [found, not_found, found_existing] = queryAll(graph, distance_oracle, lookup);
+    auto [found, not_found, found_existing] = queryAll(graph,
+                                                       distance_oracle,
+                                                       lookup,
+                                                       settings.verify_answers);
 
     writeDijkstraRankToFile(found,
                             not_found,
                             found_existing,
-                            result_folder
+                            settings.result_folder
                                 + "dijkstra_rank_"
-                                + std::to_string(max_selections));
+                                + std::to_string(settings.max_selections));
+}
+
+template<class Selections>
+auto exportGeoJson(const graph::Graph &graph,
+                   const Selections &selections,
+                   const SelectionSettings &settings)
+{
+    if(!settings.geojson_file) {
+        return;
+    }
+
+    selection::GeoJsonWriter writer{settings.geojson_file.value(), settings.geojson_options};
+    if(!writer.write(graph, selections)) {
+        fmt::print(stderr, "unable to export the selections to {}\n", settings.geojson_file.value());
+    }
+}
+
+template<class DistanceOracle>
+auto runSelection(const graph::Graph &graph,
+                  DistanceOracle &distance_oracle,
+                  const SelectionSettings &settings)
+{
+    //the loaded selections stay in the mapped file, the optimizer reads them from there
+    if(settings.selections_to_load) {
+        utils::Timer t;
+        auto selections = selection::SelectionFile::open(settings.selections_to_load.value(),
+                                                         graph.fingerprint(),
+                                                         graph.size(),
+                                                         settings.prune_distance);
+        if(!selections) {
+            return;
+        }
+
+        fmt::print("{} \t ", t.elapsed());
+
+        exportGeoJson(graph, selections.value(), settings);
+        optimizeSelections(graph, distance_oracle, settings, std::move(selections.value()));
+        return;
+    }
+
+    auto selections = withCenterCalculator(
+        graph,
+        distance_oracle,
+        settings,
+        [&](auto center_calculator) {
+            return calculateSelections(graph,
+                                       distance_oracle,
+                                       std::move(center_calculator),
+                                       settings);
+        });
+
+    if(settings.selections_to_save) {
+        selection::SelectionFileWriter writer{settings.selections_to_save.value(),
+                                              graph.fingerprint(),
+                                              graph.size(),
+                                              settings.prune_distance};
+
+        for(auto i : utils::range(selections.size())) {
+            writer.add(selections[i]);
+        }
+
+        if(!writer.finish()) {
+            fmt::print(stderr,
+                       "unable to save the selections to {}\n",
+                       settings.selections_to_save.value());
+        }
+    }
+
+    exportGeoJson(graph, selections, settings);
+    optimizeSelections(graph, distance_oracle, settings, std::move(selections));
 }
 
 auto main(int argc, char *argv[]) -> int
 {
     const auto options = utils::parseArguments(argc, argv);
-    const auto graph_file = options.getGraphFile();
-    const auto graph = graph::parseFMIFile(graph_file).value();
-    const auto prune_distance = options.getPruneDistance();
-    const auto max_selections = options.getMaxNumberOfSelectionsPerNode();
-    const auto graph_filename = utils::unquote(fs::path(graph_file).filename());
-    const auto result_folder = fmt::format("./results/{}/", graph_filename);
-
-    fs::create_directories(result_folder);
-
-    CachingDijkstra distance_oracle{graph};
-    runSelection(graph,
-                 distance_oracle,
-                 result_folder,
-                 prune_distance,
-                 max_selections);
+    const auto graph = graph::parseFMIFile(options.getGraphFile()).value();
+    const auto settings = selectionSettingsOf(options);
+
+    fs::create_directories(settings.result_folder);
+
+    const auto ran = withDistanceOracle(graph, options, settings, [&](auto &distance_oracle) {
+        runSelection(graph, distance_oracle, settings);
+    });
+
+    return ran ? 0 : 1;
 }
@@ -1,14 +1,22 @@
 #include "utils/Utils.hpp"
+#include <algorithm>
+#include <fmt/core.h>
 #include <fmt/ostream.h>
 #include <functional>
 #include <graph/Graph.hpp>
+#include <limits>
+#include <mutex>
 #include <numeric>
 #include <optional>
 #include <pathfinding/CachingDijkstra.hpp>
 #include <pathfinding/Distance.hpp>
+#include <pathfinding/OneToAllDijkstra.hpp>
+#include <pathfinding/PathWalk.hpp>
 #include <progresscpp/ProgressBar.hpp>
-#include <queue>
 #include <string_view>
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
 #include <utils/Range.hpp>
 #include <vector>
 
@@ -17,141 +25,243 @@ using graph::Graph;
 using graph::Node;
 using graph::UNREACHABLE;
 using pathfinding::CachingDijkstra;
+using pathfinding::DistanceSlice;
+using pathfinding::MatrixEntry;
+using pathfinding::OneToAllDijkstra;
+using pathfinding::Path;
 
-CachingDijkstra::CachingDijkstra(const graph::Graph& graph) noexcept
-    : graph_(graph),
-      distances_(graph.size(), UNREACHABLE),
-      settled_(graph.size(), false),
-      pq_(DijkstraQueueComparer{}),
-      distance_cache_(graph.size(),
-                      std::vector(graph.size(), UNREACHABLE))
-{
-    for(auto from : utils::range(graph_.size())) {
-        for(auto to : utils::range(graph.size())) {
-            distance_cache_[from][to] = computeDistance(from, to);
-        }
-    }
+namespace {
 
-    //cleanup everything to save memory
-    distances_.clear();
-    settled_.clear();
-    pq_ = DijkstraQueue{DijkstraQueueComparer{}};
-    touched_.clear();
-    last_source_ = std::nullopt;
-}
+constexpr auto NO_PREDECESSOR = std::numeric_limits<std::uint32_t>::max();
 
-auto CachingDijkstra::findDistance(graph::Node source,
-                                   graph::Node target) const noexcept
-    -> Distance
+auto computeDistanceMatrix(const graph::Graph& graph,
+                           std::vector<std::uint32_t>& predecessors) noexcept
+    -> pathfinding::DistanceMatrix
 {
-    return distance_cache_[source][target];
-}
+    pathfinding::DistanceMatrix matrix{graph.size()};
+    const auto with_predecessors = !predecessors.empty();
 
-auto CachingDijkstra::insertCache(graph::Node source,
-                                  graph::Node target,
-                                  graph::Distance dist) noexcept
-    -> void
-{
-    distance_cache_[target][source] = dist;
+    //every thread owns its own search workspace and fills
+    //complete rows with a single one to all search
+    tbb::enumerable_thread_specific<OneToAllDijkstra> searches{
+        [&] {
+            return OneToAllDijkstra{graph};
+        }};
+
+    progresscpp::ProgressBar bar{graph.size(), 80ul};
+    std::mutex bar_mutex;
+
+    tbb::parallel_for(
+        tbb::blocked_range<Node>(0, graph.size()),
+        [&](const auto& rows) {
+            auto& search = searches.local();
+
+            for(auto from = rows.begin(); from != rows.end(); from++) {
+                const auto& distances = search.computeDistancesFrom(from);
+                matrix.setRow(from, distances);
+
+                if(with_predecessors) {
+                    const auto& before = search.getPredecessors();
+                    std::transform(std::begin(before),
+                                   std::end(before),
+                                   std::begin(predecessors) + from * graph.size(),
+                                   [](auto node) -> std::uint32_t {
+                                       return node == graph::NOT_REACHABLE
+                                           ? NO_PREDECESSOR
+                                           : node;
+                                   });
+                }
+
+                std::lock_guard lock{bar_mutex};
+                bar++;
+                bar.displayIfChangedAtLeast(0.01);
+            }
+        });
+
+    bar.done();
+
+    return matrix;
 }
 
-auto CachingDijkstra::destroy() noexcept
+// used if the distances were loaded from a cache file, such that no search
+// was run which could have recorded the predecessors. A breadth first search
+// from every source over the edges which lie on shortest paths, those with
+// d(s, u) + w(u, v) = d(s, v), takes the place of the dijkstra search. Its
+// tree stays free of cycles on zero weight edges as well
+auto derivePredecessors(const graph::Graph& graph,
+                        const pathfinding::DistanceMatrix& matrix,
+                        std::vector<std::uint32_t>& predecessors) noexcept
     -> void
 {
-    utils::cleanAndFree(distances_);
-    utils::cleanAndFree(settled_);
-    utils::cleanAndFree(touched_);
-    utils::cleanAndFree(distance_cache_);
-}
+    tbb::enumerable_thread_specific<std::vector<Node>> queues;
 
+    tbb::parallel_for(
+        tbb::blocked_range<Node>(0, graph.size()),
+        [&](const auto& rows) {
+            auto& queue = queues.local();
 
-auto CachingDijkstra::getDistanceTo(graph::Node n) const noexcept
-    -> Distance
-{
-    return distances_[n];
+            for(auto from = rows.begin(); from != rows.end(); from++) {
+                auto* before = predecessors.data() + from * graph.size();
+                std::fill(before, before + graph.size(), NO_PREDECESSOR);
+
+                queue.clear();
+                queue.emplace_back(from);
+
+                for(std::size_t i = 0; i < queue.size(); i++) {
+                    const auto node = queue[i];
+                    const auto node_distance = matrix.get(from, node);
+
+                    for(auto [neig, distance] : graph.getForwardNeigboursOf(node)) {
+                        if(neig != from
+                           and before[neig] == NO_PREDECESSOR
+                           and node_distance + distance == matrix.get(from, neig)) {
+                            before[neig] = static_cast<std::uint32_t>(node);
+                            queue.emplace_back(neig);
+                        }
+                    }
+                }
+            }
+        });
 }
 
-auto CachingDijkstra::setDistanceTo(graph::Node n,
-                                    Distance distance) noexcept
-    -> void
+auto loadOrComputeDistanceMatrix(const graph::Graph& graph,
+                                 std::optional<std::string_view> cache_folder,
+                                 std::vector<std::uint32_t>& predecessors) noexcept
+    -> pathfinding::DistanceMatrix
 {
-    distances_[n] = distance;
+    if(!cache_folder) {
+        return computeDistanceMatrix(graph, predecessors);
+    }
+
+    const auto fingerprint = graph.fingerprint();
+    const auto path = fmt::format("{}/{:016x}.distances",
+                                  cache_folder.value(),
+                                  fingerprint);
+
+    auto cached_opt = pathfinding::DistanceMatrix::fromFile(path,
+                                                            fingerprint,
+                                                            graph.size());
+    if(cached_opt) {
+        if(!predecessors.empty()) {
+            derivePredecessors(graph, cached_opt.value(), predecessors);
+        }
+        return std::move(cached_opt.value());
+    }
+
+    auto matrix = computeDistanceMatrix(graph, predecessors);
+
+    if(!matrix.toFile(path, fingerprint)) {
+        fmt::print(stderr, "unable to store the distance matrix in {}\n", path);
+    }
+
+    return matrix;
 }
 
-auto CachingDijkstra::reset() noexcept
-    -> void
+} // namespace
+
+CachingDijkstra::CachingDijkstra(const graph::Graph& graph,
+                                 std::optional<std::string_view> cache_folder,
+                                 bool transposed_copy,
+                                 bool record_predecessors) noexcept
+    : graph_(graph),
+      //the predecessors are allocated first, such that they are filled
+      //in the same sweep as the distances
+      predecessors_(record_predecessors
+                        ? graph.size() * graph.size()
+                        : 0),
+      distance_cache_(loadOrComputeDistanceMatrix(graph, cache_folder, predecessors_))
 {
-    for(auto n : touched_) {
-        unSettle(n);
-        setDistanceTo(n, UNREACHABLE);
+    if(transposed_copy) {
+        transposed_cache_.emplace(distance_cache_.transposed());
     }
-    touched_.clear();
-    pq_ = DijkstraQueue{DijkstraQueueComparer{}};
 }
 
-auto CachingDijkstra::unSettle(graph::Node n) noexcept
-    -> void
+auto CachingDijkstra::findDistance(graph::Node source,
+                                   graph::Node target) const noexcept
+    -> Distance
 {
-    settled_[n] = false;
+    return distance_cache_.get(source, target);
 }
 
-auto CachingDijkstra::settle(graph::Node n) noexcept
-    -> void
+auto CachingDijkstra::findRoute(graph::Node source,
+                                graph::Node target) const noexcept
+    -> std::optional<Path>
 {
+    if(distance_cache_.get(source, target) == UNREACHABLE) {
+        return std::nullopt;
+    }
 
-    settled_[n] = true;
-}
+    std::vector<Node> nodes{target};
 
-auto CachingDijkstra::isSettled(graph::Node n) noexcept
-    -> bool
-{
-    return settled_[n];
+    //the predecessors form a shortest path tree of the source, the walk over
+    //them always ends at the source
+    if(hasPredecessors()) {
+        while(nodes.back() != source) {
+            auto before_opt = findPredecessor(source, nodes.back());
+            if(!before_opt) {
+                return std::nullopt;
+            }
+            nodes.emplace_back(before_opt.value());
+        }
+    } else {
+        auto walkable = walkPathBackwards(graph_, source, target, row(source), [&](auto node) {
+            nodes.emplace_back(node);
+            return true;
+        });
+
+        if(!walkable) {
+            return std::nullopt;
+        }
+    }
+
+    return Path{std::vector<Node>(std::rbegin(nodes), std::rend(nodes))};
 }
 
-auto CachingDijkstra::computeDistance(graph::Node source,
-                                      graph::Node target) noexcept
-    -> Distance
+auto CachingDijkstra::findPredecessor(graph::Node source,
+                                      graph::Node target) const noexcept
+    -> std::optional<Node>
 {
-    using graph::UNREACHABLE;
-
-    if(source == last_source_ && isSettled(target)) {
-        return getDistanceTo(target);
+    if(!hasPredecessors()) {
+        return std::nullopt;
     }
 
-    if(source != last_source_) {
-        last_source_ = source;
-        reset();
-        pq_.emplace(source, 0l);
-        setDistanceTo(source, 0);
-        touched_.emplace_back(source);
+    const auto before = predecessors_[source * graph_.size() + target];
+    if(before == NO_PREDECESSOR) {
+        return std::nullopt;
     }
 
-    while(!pq_.empty()) {
-        auto [current_node, current_dist] = pq_.top();
+    return before;
+}
 
-        settle(current_node);
+auto CachingDijkstra::hasPredecessors() const noexcept
+    -> bool
+{
+    return !predecessors_.empty();
+}
 
-        if(current_node == target) {
-            return current_dist;
-        }
+auto CachingDijkstra::row(graph::Node source) const noexcept
+    -> DistanceSlice
+{
+    return DistanceSlice{distance_cache_.row(source).data(), 1};
+}
 
-        // pop after the return, otherwise we loose a value
-        // when reusing the pq
-        pq_.pop();
+auto CachingDijkstra::column(graph::Node target) const noexcept
+    -> DistanceSlice
+{
+    if(transposed_cache_) {
+        return DistanceSlice{transposed_cache_->row(target).data(), 1};
+    }
 
-        auto neigbours = graph_.getForwardNeigboursOf(current_node);
+    return distance_cache_.column(target);
+}
 
-        for(auto [neig, dist] : neigbours) {
-            auto neig_dist = getDistanceTo(neig);
-            auto new_dist = current_dist + dist;
+auto CachingDijkstra::destroy() noexcept
+    -> void
+{
+    distance_cache_.destroy();
+    utils::cleanAndFree(predecessors_);
 
-            if(UNREACHABLE != current_dist and neig_dist > new_dist) {
-                touched_.emplace_back(neig);
-                setDistanceTo(neig, new_dist);
-                pq_.emplace(neig, new_dist);
-            }
-        }
+    if(transposed_cache_) {
+        transposed_cache_->destroy();
     }
-
-    return getDistanceTo(target);
 }
@@ -0,0 +1,30 @@
+#include <fmt/core.h>
+#include <graph/Graph.hpp>
+#include <pathfinding/CompressedCachingDijkstra.hpp>
+#include <pathfinding/Distance.hpp>
+
+using graph::Distance;
+using pathfinding::CompressedCachingDijkstra;
+
+CompressedCachingDijkstra::CompressedCachingDijkstra(const graph::Graph& graph) noexcept
+    : graph_(graph),
+      distance_cache_(graph)
+{
+    fmt::print(stderr,
+               "compressed distance matrix: {} bytes instead of {} bytes\n",
+               distance_cache_.memoryUsage(),
+               graph.size() * graph.size() * sizeof(std::uint32_t));
+}
+
+auto CompressedCachingDijkstra::findDistance(graph::Node source,
+                                             graph::Node target) const noexcept
+    -> Distance
+{
+    return distance_cache_.get(source, target);
+}
+
+auto CompressedCachingDijkstra::destroy() noexcept
+    -> void
+{
+    distance_cache_.destroy();
+}
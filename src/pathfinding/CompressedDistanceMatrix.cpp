@@ -0,0 +1,311 @@
+#include <algorithm>
+#include <graph/Graph.hpp>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <pathfinding/CompressedDistanceMatrix.hpp>
+#include <pathfinding/Distance.hpp>
+#include <pathfinding/OneToAllDijkstra.hpp>
+#include <progresscpp/ProgressBar.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <utils/Utils.hpp>
+#include <vector>
+
+using graph::Distance;
+using graph::Node;
+using graph::UNREACHABLE;
+using pathfinding::CompressedDistanceMatrix;
+using pathfinding::OneToAllDijkstra;
+
+namespace {
+
+// unreachable distances are stored as a value larger than every real
+// distance, such that the differences of two rows stay lossless
+constexpr auto UNREACHABLE_VALUE = std::int64_t{1} << 62;
+
+constexpr auto NO_LANDMARK = std::numeric_limits<std::uint32_t>::max();
+
+auto toValues(const std::vector<Distance>& distances) noexcept
+    -> std::vector<std::int64_t>
+{
+    std::vector<std::int64_t> values(distances.size());
+    std::transform(std::begin(distances),
+                   std::end(distances),
+                   std::begin(values),
+                   [](auto distance) {
+                       return distance == UNREACHABLE
+                           ? UNREACHABLE_VALUE
+                           : distance;
+                   });
+
+    return values;
+}
+
+auto bitWidth(std::uint64_t range) noexcept
+    -> std::uint8_t
+{
+    if(range == 0) {
+        return 0;
+    }
+
+    return 64 - __builtin_clzll(range);
+}
+
+// farthest point selection: the next landmark is always the node which is
+// farthest away from all landmarks chosen so far
+auto selectLandmarks(const graph::Graph& graph,
+                     std::size_t number_of_landmarks) noexcept
+    -> std::pair<std::vector<Node>,
+                 std::vector<std::vector<std::int64_t>>>
+{
+    OneToAllDijkstra search{graph};
+
+    std::vector<Node> landmarks;
+    std::vector<std::vector<std::int64_t>> landmark_rows;
+    std::vector<std::int64_t> min_dist(graph.size(),
+                                       std::numeric_limits<std::int64_t>::max());
+
+    Node next = 0;
+    while(landmarks.size() < number_of_landmarks) {
+        auto row = toValues(search.computeDistancesFrom(next));
+
+        for(std::size_t n = 0; n < graph.size(); n++) {
+            min_dist[n] = std::min(min_dist[n], row[n]);
+        }
+
+        landmarks.emplace_back(next);
+        landmark_rows.emplace_back(std::move(row));
+
+        auto farthest = std::max_element(std::begin(min_dist),
+                                         std::end(min_dist));
+        if(*farthest == 0) {
+            break;
+        }
+
+        next = std::distance(std::begin(min_dist), farthest);
+    }
+
+    return std::pair{std::move(landmarks),
+                     std::move(landmark_rows)};
+}
+
+} // namespace
+
+CompressedDistanceMatrix::CompressedDistanceMatrix(const graph::Graph& graph) noexcept
+    : number_of_nodes_(graph.size()),
+      blocks_per_row_((graph.size() + BLOCK_SIZE - 1) / BLOCK_SIZE),
+      reference_(graph.size()),
+      row_offset_(graph.size() + 1, 0),
+      block_offset_(graph.size() * blocks_per_row_),
+      block_base_(graph.size() * blocks_per_row_),
+      block_width_(graph.size() * blocks_per_row_)
+{
+    auto number_of_landmarks = std::max<std::size_t>(1, number_of_nodes_ / LANDMARK_RATIO);
+    auto [landmarks, landmark_rows] = selectLandmarks(graph, number_of_landmarks);
+
+    std::vector<std::uint32_t> landmark_index(number_of_nodes_, NO_LANDMARK);
+    for(std::size_t i = 0; i < landmarks.size(); i++) {
+        landmark_index[landmarks[i]] = i;
+    }
+
+    tbb::enumerable_thread_specific<OneToAllDijkstra> searches{
+        [&] {
+            return OneToAllDijkstra{graph};
+        }};
+
+    progresscpp::ProgressBar bar{number_of_nodes_, 80ul};
+    std::mutex bar_mutex;
+
+    //the rows are packed independently first and
+    //concatenated when all of them are known
+    std::vector<std::vector<std::uint64_t>> packed_rows(number_of_nodes_);
+
+    tbb::parallel_for(
+        tbb::blocked_range<Node>(0, number_of_nodes_),
+        [&](const auto& rows) {
+            auto& search = searches.local();
+
+            for(auto row = rows.begin(); row != rows.end(); row++) {
+                if(landmark_index[row] != NO_LANDMARK) {
+                    reference_[row] = row;
+                    packed_rows[row] = encodeRow(row, landmark_rows[landmark_index[row]]);
+                } else {
+                    auto values = toValues(search.computeDistancesFrom(row));
+
+                    //the closest landmark in both directions bounds the differences
+                    auto round_trip = [&](auto landmark) {
+                        const auto& landmark_row = landmark_rows[landmark_index[landmark]];
+                        return static_cast<std::uint64_t>(values[landmark])
+                            + static_cast<std::uint64_t>(landmark_row[row]);
+                    };
+
+                    auto best = std::min_element(
+                        std::begin(landmarks),
+                        std::end(landmarks),
+                        [&](auto lhs, auto rhs) {
+                            return round_trip(lhs) < round_trip(rhs);
+                        });
+
+                    const auto& reference_row = landmark_rows[landmark_index[*best]];
+                    for(std::size_t column = 0; column < number_of_nodes_; column++) {
+                        values[column] -= reference_row[column];
+                    }
+
+                    reference_[row] = *best;
+                    packed_rows[row] = encodeRow(row, values);
+                }
+
+                std::lock_guard lock{bar_mutex};
+                bar++;
+                bar.displayIfChangedAtLeast(0.01);
+            }
+        });
+
+    bar.done();
+
+    for(std::size_t row = 0; row < number_of_nodes_; row++) {
+        row_offset_[row + 1] = row_offset_[row] + packed_rows[row].size() * 64;
+    }
+
+    //one additional word, such that decoding can always read two words
+    packed_.resize(row_offset_.back() / 64 + 1, 0);
+
+    tbb::parallel_for(
+        tbb::blocked_range<Node>(0, number_of_nodes_),
+        [&](const auto& rows) {
+            for(auto row = rows.begin(); row != rows.end(); row++) {
+                std::copy(std::begin(packed_rows[row]),
+                          std::end(packed_rows[row]),
+                          std::begin(packed_) + row_offset_[row] / 64);
+                utils::cleanAndFree(packed_rows[row]);
+            }
+        });
+}
+
+auto CompressedDistanceMatrix::get(graph::Node source,
+                                   graph::Node target) const noexcept
+    -> Distance
+{
+    auto value = decode(source, target);
+
+    auto reference = reference_[source];
+    if(reference != source) {
+        value += decode(reference, target);
+    }
+
+    if(value >= UNREACHABLE_VALUE) {
+        return UNREACHABLE;
+    }
+
+    return value;
+}
+
+auto CompressedDistanceMatrix::size() const noexcept
+    -> std::size_t
+{
+    return number_of_nodes_;
+}
+
+auto CompressedDistanceMatrix::memoryUsage() const noexcept
+    -> std::size_t
+{
+    return reference_.size() * sizeof(std::uint32_t)
+        + row_offset_.size() * sizeof(std::uint64_t)
+        + block_offset_.size() * sizeof(std::uint32_t)
+        + block_base_.size() * sizeof(std::int64_t)
+        + block_width_.size() * sizeof(std::uint8_t)
+        + packed_.size() * sizeof(std::uint64_t);
+}
+
+auto CompressedDistanceMatrix::destroy() noexcept
+    -> void
+{
+    utils::cleanAndFree(reference_);
+    utils::cleanAndFree(row_offset_);
+    utils::cleanAndFree(block_offset_);
+    utils::cleanAndFree(block_base_);
+    utils::cleanAndFree(block_width_);
+    utils::cleanAndFree(packed_);
+    number_of_nodes_ = 0;
+    blocks_per_row_ = 0;
+}
+
+auto CompressedDistanceMatrix::decode(graph::Node row,
+                                      graph::Node column) const noexcept
+    -> std::int64_t
+{
+    const auto block = row * blocks_per_row_ + column / BLOCK_SIZE;
+    const auto width = block_width_[block];
+    const auto base = block_base_[block];
+
+    if(width == 0) {
+        return base;
+    }
+
+    const auto bit = row_offset_[row]
+        + block_offset_[block]
+        + (column % BLOCK_SIZE) * width;
+
+    const auto word = bit / 64;
+    const auto shift = bit % 64;
+
+    auto bits = packed_[word] >> shift;
+    if(shift + width > 64) {
+        bits |= packed_[word + 1] << (64 - shift);
+    }
+
+    const auto mask = width == 64
+        ? std::numeric_limits<std::uint64_t>::max()
+        : (std::uint64_t{1} << width) - 1;
+
+    //unsigned arithmetic, the range of a block can exceed the signed range
+    return static_cast<std::int64_t>(static_cast<std::uint64_t>(base) + (bits & mask));
+}
+
+auto CompressedDistanceMatrix::encodeRow(graph::Node row,
+                                         const std::vector<std::int64_t>& values) noexcept
+    -> std::vector<std::uint64_t>
+{
+    const auto first_block = row * blocks_per_row_;
+    std::uint64_t number_of_bits = 0;
+
+    for(std::size_t block = 0; block < blocks_per_row_; block++) {
+        const auto begin = std::begin(values) + block * BLOCK_SIZE;
+        const auto end = std::begin(values) + std::min(number_of_nodes_, (block + 1) * BLOCK_SIZE);
+        const auto [min, max] = std::minmax_element(begin, end);
+        const auto width = bitWidth(static_cast<std::uint64_t>(*max)
+                                    - static_cast<std::uint64_t>(*min));
+
+        block_base_[first_block + block] = *min;
+        block_width_[first_block + block] = width;
+        block_offset_[first_block + block] = number_of_bits;
+
+        number_of_bits += width * std::distance(begin, end);
+    }
+
+    std::vector<std::uint64_t> packed((number_of_bits + 63) / 64, 0);
+
+    for(std::size_t column = 0; column < number_of_nodes_; column++) {
+        const auto block = first_block + column / BLOCK_SIZE;
+        const auto width = block_width_[block];
+
+        if(width == 0) {
+            continue;
+        }
+
+        const auto bits = static_cast<std::uint64_t>(values[column])
+            - static_cast<std::uint64_t>(block_base_[block]);
+        const auto bit = block_offset_[block] + (column % BLOCK_SIZE) * width;
+        const auto word = bit / 64;
+        const auto shift = bit % 64;
+
+        packed[word] |= bits << shift;
+        if(shift + width > 64) {
+            packed[word + 1] |= bits >> (64 - shift);
+        }
+    }
+
+    return packed;
+}
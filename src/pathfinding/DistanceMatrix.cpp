@@ -0,0 +1,398 @@
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fmt/core.h>
+#include <fstream>
+#include <graph/Graph.hpp>
+#include <new>
+#if defined(__AVX2__) and !defined(WIDE_DISTANCE_MATRIX)
+#include <immintrin.h>
+#endif
+#include <pathfinding/Distance.hpp>
+#include <pathfinding/DistanceMatrix.hpp>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <unistd.h>
+#include <utils/Utils.hpp>
+#include <vector>
+
+using graph::Distance;
+using graph::Node;
+using graph::UNREACHABLE;
+using pathfinding::DistanceSlice;
+using pathfinding::DistanceMatrix;
+using pathfinding::MatrixEntry;
+
+namespace {
+
+auto calculateRowStride(std::size_t number_of_nodes) noexcept
+    -> std::size_t
+{
+    constexpr auto entries_per_line = DistanceMatrix::ALIGNMENT / sizeof(MatrixEntry);
+    return (number_of_nodes + entries_per_line - 1) / entries_per_line * entries_per_line;
+}
+
+constexpr auto FILE_MAGIC = std::uint64_t{0x5854414d54534944}; // "DISTMATX"
+constexpr auto FILE_VERSION = std::uint64_t{1};
+
+// the header fills a whole page, such that the mapped rows keep their alignment
+constexpr auto HEADER_SIZE = std::size_t{4096};
+
+struct FileHeader
+{
+    std::uint64_t magic;
+    std::uint64_t version;
+    std::uint64_t entry_size;
+    std::uint64_t number_of_nodes;
+    std::uint64_t row_stride;
+    std::uint64_t fingerprint;
+};
+
+static_assert(sizeof(FileHeader) <= HEADER_SIZE);
+
+// the matrix is transposed in square tiles, such that the lines which are
+// read and the lines which are written stay in the cache for a whole tile
+constexpr auto TILE_SIZE = std::size_t{64};
+
+} // namespace
+
+#if defined(__AVX2__) and !defined(WIDE_DISTANCE_MATRIX)
+
+namespace {
+
+// gathering does not pay off for a few nodes, most checks fail early
+constexpr auto MIN_GATHERED_NODES = std::size_t{16};
+
+// positions of the entries of four nodes in a slice with the given stride
+auto entryIndices(const std::pair<Node, Distance>* nodes,
+                  std::size_t stride) noexcept
+    -> __m256i
+{
+    return _mm256_set_epi64x(static_cast<long long>(nodes[3].first * stride),
+                             static_cast<long long>(nodes[2].first * stride),
+                             static_cast<long long>(nodes[1].first * stride),
+                             static_cast<long long>(nodes[0].first * stride));
+}
+
+// the four entries widened to 64 bit, unreachable entries stay all ones
+// in the lower half and never equal a sum of two stored distances
+auto gatherEntries(const MatrixEntry* entries, __m256i indices) noexcept
+    -> __m256i
+{
+    const auto gathered = _mm256_i64gather_epi32(reinterpret_cast<const int*>(entries),
+                                                 indices,
+                                                 sizeof(MatrixEntry));
+    return _mm256_cvtepu32_epi64(gathered);
+}
+
+auto isReachable(__m256i entries) noexcept
+    -> __m256i
+{
+    const auto unreachable = _mm256_set1_epi64x(
+        static_cast<long long>(DistanceMatrix::UNREACHABLE_ENTRY));
+    return _mm256_xor_si256(_mm256_cmpeq_epi64(entries, unreachable),
+                            _mm256_set1_epi64x(-1));
+}
+
+} // namespace
+
+#endif
+
+auto DistanceSlice::matchesAll(Distance offset,
+                               NodeDistances nodes) const noexcept
+    -> bool
+{
+    std::size_t i = 0;
+
+#if defined(__AVX2__) and !defined(WIDE_DISTANCE_MATRIX)
+    const auto offsets = _mm256_set1_epi64x(offset);
+
+    for(; nodes.size() >= MIN_GATHERED_NODES and i + 4 <= nodes.size(); i += 4) {
+        const auto* four = &nodes[i];
+        const auto entries = gatherEntries(entries_, entryIndices(four, stride_));
+        const auto expected = _mm256_add_epi64(
+            offsets,
+            _mm256_set_epi64x(four[3].second, four[2].second, four[1].second, four[0].second));
+
+        const auto equal = _mm256_and_si256(_mm256_cmpeq_epi64(entries, expected),
+                                            isReachable(entries));
+        if(_mm256_movemask_epi8(equal) != -1) {
+            return false;
+        }
+    }
+#endif
+
+    for(; i < nodes.size(); i++) {
+        auto [n, distance] = nodes[i];
+        if((*this)[n] != offset + distance) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+auto DistanceSlice::matchesAll(Distance offset,
+                               const DistanceSlice& other,
+                               NodeDistances nodes) const noexcept
+    -> bool
+{
+    std::size_t i = 0;
+
+#if defined(__AVX2__) and !defined(WIDE_DISTANCE_MATRIX)
+    const auto offsets = _mm256_set1_epi64x(offset);
+
+    for(; nodes.size() >= MIN_GATHERED_NODES and i + 4 <= nodes.size(); i += 4) {
+        const auto* four = &nodes[i];
+        const auto entries = gatherEntries(entries_, entryIndices(four, stride_));
+        const auto other_entries = gatherEntries(other.entries_, entryIndices(four, other.stride_));
+        const auto expected = _mm256_add_epi64(offsets, other_entries);
+
+        const auto equal = _mm256_and_si256(
+            _mm256_cmpeq_epi64(entries, expected),
+            _mm256_and_si256(isReachable(entries), isReachable(other_entries)));
+        if(_mm256_movemask_epi8(equal) != -1) {
+            return false;
+        }
+    }
+#endif
+
+    for(; i < nodes.size(); i++) {
+        const auto n = nodes[i].first;
+        const auto other_distance = other[n];
+        if(other_distance == UNREACHABLE or (*this)[n] != offset + other_distance) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+DistanceMatrix::DistanceMatrix(std::size_t number_of_nodes) noexcept
+    : number_of_nodes_(number_of_nodes),
+      row_stride_(calculateRowStride(number_of_nodes)),
+      //the entries are left uninitialized, such that the pages are
+      //touched first by the threads which fill the rows
+      entries_(new(std::align_val_t{ALIGNMENT}) MatrixEntry[number_of_nodes_ * row_stride_],
+               EntryDelete{}) {}
+
+DistanceMatrix::DistanceMatrix(std::size_t number_of_nodes,
+                               MatrixEntry* entries,
+                               std::size_t mapped_bytes) noexcept
+    : number_of_nodes_(number_of_nodes),
+      row_stride_(calculateRowStride(number_of_nodes)),
+      entries_(entries, EntryDelete{mapped_bytes}) {}
+
+auto DistanceMatrix::EntryDelete::operator()(MatrixEntry* entries) const noexcept
+    -> void
+{
+    if(mapped_bytes == 0) {
+        ::operator delete[](entries, std::align_val_t{ALIGNMENT});
+        return;
+    }
+
+    auto* mapping = reinterpret_cast<char*>(entries) - HEADER_SIZE;
+    munmap(mapping, mapped_bytes);
+}
+
+auto DistanceMatrix::get(graph::Node source,
+                         graph::Node target) const noexcept
+    -> Distance
+{
+    return toDistance(entries_[source * row_stride_ + target]);
+}
+
+auto DistanceMatrix::row(graph::Node source) const noexcept
+    -> nonstd::span<const MatrixEntry>
+{
+    return nonstd::span<const MatrixEntry>{&entries_[source * row_stride_],
+                                           row_stride_};
+}
+
+auto DistanceMatrix::column(graph::Node target) const noexcept
+    -> DistanceSlice
+{
+    return DistanceSlice{&entries_[target], row_stride_};
+}
+
+auto DistanceMatrix::transposed() const noexcept
+    -> DistanceMatrix
+{
+    DistanceMatrix transposed{number_of_nodes_};
+    auto* target_entries = transposed.entries_.get();
+    const auto* source_entries = entries_.get();
+
+    const auto number_of_tiles = (row_stride_ + TILE_SIZE - 1) / TILE_SIZE;
+
+    //every task owns a band of rows of the transposed matrix
+    tbb::parallel_for(
+        tbb::blocked_range<std::size_t>(0, number_of_tiles),
+        [&](const auto& tiles) {
+            for(auto column_tile = tiles.begin(); column_tile != tiles.end(); column_tile++) {
+                const auto first_column = column_tile * TILE_SIZE;
+                const auto last_column = std::min(number_of_nodes_, first_column + TILE_SIZE);
+
+                for(std::size_t first_row = 0; first_row < row_stride_; first_row += TILE_SIZE) {
+                    const auto last_row = std::min(row_stride_, first_row + TILE_SIZE);
+
+                    for(auto column = first_column; column < last_column; column++) {
+                        auto* target_row = &target_entries[column * row_stride_];
+
+                        for(auto row = first_row; row < last_row; row++) {
+                            target_row[row] = row < number_of_nodes_
+                                ? source_entries[row * row_stride_ + column]
+                                : UNREACHABLE_ENTRY;
+                        }
+                    }
+                }
+            }
+        });
+
+    return transposed;
+}
+
+auto DistanceMatrix::setRow(graph::Node source,
+                            const std::vector<Distance>& distances) noexcept
+    -> void
+{
+    auto* row = &entries_[source * row_stride_];
+
+    for(std::size_t target = 0; target < number_of_nodes_; target++) {
+        auto distance = distances[target];
+
+        if(distance == UNREACHABLE) {
+            row[target] = UNREACHABLE_ENTRY;
+            continue;
+        }
+
+        row[target] = static_cast<MatrixEntry>(distance);
+    }
+
+    std::fill(row + number_of_nodes_,
+              row + row_stride_,
+              UNREACHABLE_ENTRY);
+}
+
+auto DistanceMatrix::canHoldDistancesOf(const graph::Graph& graph) noexcept
+    -> bool
+{
+    std::uint64_t longest_path = 0;
+
+    for(graph::Node node = 0; node < graph.size(); node++) {
+        graph::Distance heaviest = 0;
+        for(auto [_, distance] : graph.getForwardNeigboursOf(node)) {
+            heaviest = std::max(heaviest, distance);
+        }
+
+        longest_path += static_cast<std::uint64_t>(heaviest);
+        if(longest_path > static_cast<std::uint64_t>(MAX_DISTANCE)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+auto DistanceMatrix::size() const noexcept
+    -> std::size_t
+{
+    return number_of_nodes_;
+}
+
+auto DistanceMatrix::destroy() noexcept
+    -> void
+{
+    entries_.reset();
+    number_of_nodes_ = 0;
+    row_stride_ = 0;
+}
+
+auto DistanceMatrix::toFile(std::string_view path, std::uint64_t fingerprint) const noexcept
+    -> bool
+{
+    //write into a temporary file first, such that an interrupted
+    //write never leaves a truncated matrix behind
+    const auto tmp_path = utils::temporaryPathOf(path);
+
+    std::ofstream file{tmp_path, std::ios::binary};
+    if(!file) {
+        fmt::print(stderr, "unable to open file {}\n", tmp_path);
+        return false;
+    }
+
+    FileHeader header{FILE_MAGIC,
+                      FILE_VERSION,
+                      sizeof(MatrixEntry),
+                      number_of_nodes_,
+                      row_stride_,
+                      fingerprint};
+
+    std::vector<char> header_page(HEADER_SIZE, 0);
+    std::memcpy(header_page.data(), &header, sizeof(header));
+
+    file.write(header_page.data(), header_page.size());
+    file.write(reinterpret_cast<const char*>(entries_.get()),
+               number_of_nodes_ * row_stride_ * sizeof(MatrixEntry));
+    file.close();
+
+    if(!file) {
+        fmt::print(stderr, "unable to write file {}\n", tmp_path);
+        std::filesystem::remove(tmp_path);
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tmp_path, path, error);
+
+    return !error;
+}
+
+auto DistanceMatrix::fromFile(std::string_view path,
+                              std::uint64_t fingerprint,
+                              std::size_t number_of_nodes) noexcept
+    -> std::optional<DistanceMatrix>
+{
+    auto fd = open(std::string{path}.c_str(), O_RDONLY);
+    if(fd < 0) {
+        return std::nullopt;
+    }
+
+    const auto row_stride = calculateRowStride(number_of_nodes);
+    const auto expected_size = HEADER_SIZE + number_of_nodes * row_stride * sizeof(MatrixEntry);
+
+    struct stat file_stat;
+    if(fstat(fd, &file_stat) != 0
+       or static_cast<std::size_t>(file_stat.st_size) != expected_size) {
+        close(fd);
+        return std::nullopt;
+    }
+
+    auto* mapping = mmap(nullptr, expected_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if(mapping == MAP_FAILED) {
+        return std::nullopt;
+    }
+
+    FileHeader header;
+    std::memcpy(&header, mapping, sizeof(header));
+
+    if(header.magic != FILE_MAGIC
+       or header.version != FILE_VERSION
+       or header.entry_size != sizeof(MatrixEntry)
+       or header.number_of_nodes != number_of_nodes
+       or header.row_stride != row_stride
+       or header.fingerprint != fingerprint) {
+        munmap(mapping, expected_size);
+        return std::nullopt;
+    }
+
+    auto* entries = reinterpret_cast<MatrixEntry*>(static_cast<char*>(mapping) + HEADER_SIZE);
+
+    return DistanceMatrix{number_of_nodes,
+                          entries,
+                          expected_size};
+}
@@ -0,0 +1,76 @@
+#include <graph/Graph.hpp>
+#include <optional>
+#include <pathfinding/Distance.hpp>
+#include <pathfinding/IncrementalDijkstra.hpp>
+#include <vector>
+
+using graph::Distance;
+using graph::Node;
+using graph::UNREACHABLE;
+using pathfinding::IncrementalDijkstra;
+
+IncrementalDijkstra::IncrementalDijkstra(const graph::Graph& graph,
+                                         Direction direction) noexcept
+    : graph_(graph),
+      direction_(direction),
+      distances_(graph.size(), UNREACHABLE),
+      settled_(graph.size(), false),
+      pq_(DijkstraQueueComparer{}) {}
+
+auto IncrementalDijkstra::start(graph::Node source) noexcept
+    -> void
+{
+    reset();
+
+    distances_[source] = 0;
+    touched_.emplace_back(source);
+    pq_.emplace(source, 0l);
+}
+
+auto IncrementalDijkstra::settleNext() noexcept
+    -> std::optional<std::pair<Node, Distance>>
+{
+    while(!pq_.empty()) {
+        auto [current_node, current_dist] = pq_.top();
+        pq_.pop();
+
+        //skip outdated queue entries
+        if(settled_[current_node]) {
+            continue;
+        }
+
+        settled_[current_node] = true;
+
+        auto neigbours = direction_ == Direction::FORWARD
+            ? graph_.getForwardNeigboursOf(current_node)
+            : graph_.getBackwardNeigboursOf(current_node);
+
+        for(auto [neig, distance] : neigbours) {
+            auto new_dist = current_dist + distance;
+
+            if(distances_[neig] > new_dist) {
+                if(distances_[neig] == UNREACHABLE) {
+                    touched_.emplace_back(neig);
+                }
+                distances_[neig] = new_dist;
+                pq_.emplace(neig, new_dist);
+            }
+        }
+
+        return std::pair{current_node, current_dist};
+    }
+
+    return std::nullopt;
+}
+
+auto IncrementalDijkstra::reset() noexcept
+    -> void
+{
+    for(auto n : touched_) {
+        distances_[n] = UNREACHABLE;
+        settled_[n] = false;
+    }
+
+    touched_.clear();
+    pq_ = DijkstraQueue{DijkstraQueueComparer{}};
+}
@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <graph/Graph.hpp>
+#include <limits>
+#include <optional>
+#include <pathfinding/Distance.hpp>
+#include <pathfinding/DistanceMatrix.hpp>
+#include <pathfinding/LazyCachingDijkstra.hpp>
+#include <pathfinding/OneToAllDijkstra.hpp>
+#include <vector>
+
+using graph::Distance;
+using graph::Node;
+using graph::UNREACHABLE;
+using pathfinding::DistanceMatrix;
+using pathfinding::LazyCachingDijkstra;
+using pathfinding::MatrixEntry;
+using pathfinding::OneToAllDijkstra;
+
+namespace {
+
+constexpr auto NO_SLOT = std::numeric_limits<std::uint32_t>::max();
+constexpr auto NO_OWNER = std::numeric_limits<std::uint32_t>::max();
+
+auto calculateNumberOfSlots(std::size_t number_of_nodes,
+                            std::size_t memory_budget) noexcept
+    -> std::size_t
+{
+    const auto row_size = std::max<std::size_t>(1, number_of_nodes * sizeof(MatrixEntry));
+    return std::clamp<std::size_t>(memory_budget / row_size,
+                                   1,
+                                   std::max<std::size_t>(1, number_of_nodes));
+}
+
+} // namespace
+
+LazyCachingDijkstra::LazyCachingDijkstra(const graph::Graph& graph,
+                                         std::size_t memory_budget) noexcept
+    : graph_(graph),
+      number_of_nodes_(graph.size()),
+      number_of_slots_(calculateNumberOfSlots(graph.size(), memory_budget)),
+      slots_(new Slot[number_of_slots_]),
+      entries_(new std::atomic<MatrixEntry>[number_of_slots_ * number_of_nodes_]),
+      slot_of_(new std::atomic<std::uint32_t>[number_of_nodes_]),
+      searches_(std::make_unique<SearchSpaces>([&graph] {
+          return OneToAllDijkstra{graph};
+      }))
+{
+    for(std::size_t i = 0; i < number_of_slots_; i++) {
+        slots_[i].owner.store(NO_OWNER, std::memory_order_relaxed);
+    }
+
+    for(std::size_t n = 0; n < number_of_nodes_; n++) {
+        slot_of_[n].store(NO_SLOT, std::memory_order_relaxed);
+    }
+}
+
+auto LazyCachingDijkstra::findDistance(graph::Node source,
+                                       graph::Node target) const noexcept
+    -> Distance
+{
+    auto cached_opt = tryCachedDistance(source, target);
+    if(cached_opt) {
+        return cached_opt.value();
+    }
+
+    misses_.fetch_add(1, std::memory_order_relaxed);
+
+    const auto& distances = searches_->local().computeDistancesFrom(source);
+    insertRow(source, distances);
+
+    return distances[target];
+}
+
+auto LazyCachingDijkstra::numberOfSlots() const noexcept
+    -> std::size_t
+{
+    return number_of_slots_;
+}
+
+auto LazyCachingDijkstra::numberOfMisses() const noexcept
+    -> std::size_t
+{
+    return misses_.load(std::memory_order_relaxed);
+}
+
+auto LazyCachingDijkstra::destroy() noexcept
+    -> void
+{
+    slots_.reset();
+    entries_.reset();
+    slot_of_.reset();
+    searches_.reset();
+    number_of_nodes_ = 0;
+    number_of_slots_ = 0;
+}
+
+auto LazyCachingDijkstra::tryCachedDistance(graph::Node source,
+                                            graph::Node target) const noexcept
+    -> std::optional<Distance>
+{
+    const auto slot_idx = slot_of_[source].load(std::memory_order_acquire);
+    if(slot_idx == NO_SLOT) {
+        return std::nullopt;
+    }
+
+    auto& slot = slots_[slot_idx];
+    const auto before = slot.sequence.load(std::memory_order_acquire);
+
+    //the slot is rewritten right now or was already handed to another source
+    if(before % 2 == 1
+       or slot.owner.load(std::memory_order_relaxed) != source) {
+        return std::nullopt;
+    }
+
+    const auto entry = entries_[slot_idx * number_of_nodes_ + target].load(std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if(slot.sequence.load(std::memory_order_relaxed) != before) {
+        return std::nullopt;
+    }
+
+    slot.referenced.store(true, std::memory_order_relaxed);
+
+    return DistanceMatrix::toDistance(entry);
+}
+
+auto LazyCachingDijkstra::insertRow(graph::Node source,
+                                    const std::vector<Distance>& distances) const noexcept
+    -> void
+{
+    std::lock_guard lock{eviction_mutex_};
+
+    //another thread computed the same row in the meantime
+    if(slot_of_[source].load(std::memory_order_relaxed) != NO_SLOT) {
+        return;
+    }
+
+    const auto victim = findVictim();
+    auto& slot = slots_[victim];
+
+    const auto sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const auto old_owner = slot.owner.load(std::memory_order_relaxed);
+    if(old_owner != NO_OWNER) {
+        slot_of_[old_owner].store(NO_SLOT, std::memory_order_relaxed);
+    }
+
+    slot.owner.store(source, std::memory_order_relaxed);
+
+    auto* row = &entries_[victim * number_of_nodes_];
+    for(std::size_t target = 0; target < number_of_nodes_; target++) {
+        const auto distance = distances[target];
+
+        if(distance == UNREACHABLE) {
+            row[target].store(DistanceMatrix::UNREACHABLE_ENTRY, std::memory_order_relaxed);
+            continue;
+        }
+
+        row[target].store(static_cast<MatrixEntry>(distance), std::memory_order_relaxed);
+    }
+
+    slot.referenced.store(true, std::memory_order_relaxed);
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    slot_of_[source].store(victim, std::memory_order_release);
+}
+
+auto LazyCachingDijkstra::findVictim() const noexcept
+    -> std::size_t
+{
+    while(true) {
+        auto& slot = slots_[clock_hand_];
+        const auto current = clock_hand_;
+        clock_hand_ = (clock_hand_ + 1) % number_of_slots_;
+
+        //recently used slots get a second chance
+        if(!slot.referenced.exchange(false, std::memory_order_relaxed)) {
+            return current;
+        }
+    }
+}
@@ -0,0 +1,83 @@
+#include <graph/Graph.hpp>
+#include <pathfinding/Distance.hpp>
+#include <pathfinding/OneToAllDijkstra.hpp>
+#include <vector>
+
+using graph::Distance;
+using graph::Node;
+using graph::UNREACHABLE;
+using pathfinding::OneToAllDijkstra;
+
+OneToAllDijkstra::OneToAllDijkstra(const graph::Graph& graph) noexcept
+    : graph_(graph),
+      distances_(graph.size(), UNREACHABLE),
+      predecessors_(graph.size(), graph::NOT_REACHABLE),
+      pq_(DijkstraQueueComparer{}) {}
+
+auto OneToAllDijkstra::computeDistancesFrom(graph::Node source) noexcept
+    -> const std::vector<Distance>&
+{
+    reset();
+
+    pq_.emplace(source, 0l);
+    setDistanceTo(source, 0);
+    touched_.emplace_back(source);
+
+    while(!pq_.empty()) {
+        auto [current_node, current_dist] = pq_.top();
+        pq_.pop();
+
+        //skip outdated queue entries
+        if(current_dist > getDistanceTo(current_node)) {
+            continue;
+        }
+
+        auto neigbours = graph_.getForwardNeigboursOf(current_node);
+
+        for(auto [neig, distance] : neigbours) {
+            auto neig_dist = getDistanceTo(neig);
+            auto new_dist = current_dist + distance;
+
+            if(neig_dist > new_dist) {
+                if(neig_dist == UNREACHABLE) {
+                    touched_.emplace_back(neig);
+                }
+                setDistanceTo(neig, new_dist);
+                predecessors_[neig] = current_node;
+                pq_.emplace(neig, new_dist);
+            }
+        }
+    }
+
+    return distances_;
+}
+
+auto OneToAllDijkstra::getPredecessors() const noexcept
+    -> const std::vector<Node>&
+{
+    return predecessors_;
+}
+
+auto OneToAllDijkstra::getDistanceTo(graph::Node n) const noexcept
+    -> Distance
+{
+    return distances_[n];
+}
+
+auto OneToAllDijkstra::setDistanceTo(graph::Node n, Distance distance) noexcept
+    -> void
+{
+    distances_[n] = distance;
+}
+
+auto OneToAllDijkstra::reset() noexcept
+    -> void
+{
+    for(auto n : touched_) {
+        setDistanceTo(n, UNREACHABLE);
+        predecessors_[n] = graph::NOT_REACHABLE;
+    }
+
+    touched_.clear();
+    pq_ = DijkstraQueue{DijkstraQueueComparer{}};
+}
@@ -0,0 +1,101 @@
+#include <filesystem>
+#include <fmt/core.h>
+#include <fstream>
+#include <optional>
+#include <selection/CentralityCache.hpp>
+#include <string>
+#include <string_view>
+#include <utils/Utils.hpp>
+#include <vector>
+
+namespace {
+
+constexpr auto FILE_MAGIC = std::uint64_t{0x59544c52544e4543}; // "CENTRLTY"
+constexpr auto FILE_VERSION = std::uint64_t{1};
+
+struct FileHeader
+{
+    std::uint64_t magic;
+    std::uint64_t version;
+    std::uint64_t number_of_nodes;
+    std::uint64_t fingerprint;
+};
+
+} // namespace
+
+auto selection::centralityCachePath(std::string_view cache_folder,
+                                    std::string_view kind,
+                                    std::uint64_t fingerprint) noexcept
+    -> std::string
+{
+    return fmt::format("{}/{:016x}.{}", cache_folder, fingerprint, kind);
+}
+
+auto selection::loadCentrality(std::string_view path,
+                               std::uint64_t fingerprint,
+                               std::size_t number_of_nodes) noexcept
+    -> std::optional<std::vector<double>>
+{
+    std::ifstream file{std::string{path}, std::ios::binary};
+    if(!file) {
+        return std::nullopt;
+    }
+
+    FileHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    if(!file
+       or header.magic != FILE_MAGIC
+       or header.version != FILE_VERSION
+       or header.number_of_nodes != number_of_nodes
+       or header.fingerprint != fingerprint) {
+        return std::nullopt;
+    }
+
+    std::vector<double> centrality(number_of_nodes);
+    file.read(reinterpret_cast<char*>(centrality.data()),
+              centrality.size() * sizeof(double));
+
+    if(!file) {
+        return std::nullopt;
+    }
+
+    return centrality;
+}
+
+auto selection::storeCentrality(std::string_view path,
+                                std::uint64_t fingerprint,
+                                const std::vector<double>& centrality) noexcept
+    -> bool
+{
+    //written next to the final file and renamed, such that
+    //an interrupted run never leaves a truncated file behind
+    const auto tmp_path = utils::temporaryPathOf(path);
+
+    std::ofstream file{tmp_path, std::ios::binary};
+    if(!file) {
+        fmt::print(stderr, "unable to open file {}\n", tmp_path);
+        return false;
+    }
+
+    FileHeader header{FILE_MAGIC,
+                      FILE_VERSION,
+                      centrality.size(),
+                      fingerprint};
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(centrality.data()),
+               centrality.size() * sizeof(double));
+    file.close();
+
+    if(!file) {
+        fmt::print(stderr, "unable to write file {}\n", tmp_path);
+        std::filesystem::remove(tmp_path);
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tmp_path, std::string{path}, error);
+
+    return !error;
+}
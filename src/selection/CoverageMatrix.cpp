@@ -0,0 +1,201 @@
+#include <graph/Graph.hpp>
+#include <selection/CoverageMatrix.hpp>
+#include <utility>
+#include <utils/Utils.hpp>
+#include <vector>
+
+using selection::CoverageMatrix;
+
+namespace {
+
+constexpr auto WORD_BITS = std::size_t{64};
+constexpr auto ALL_COVERED = ~std::uint64_t{0};
+constexpr auto WORDS_PER_BLOCK = std::size_t{8};
+
+} // namespace
+
+CoverageMatrix::CoverageMatrix(std::size_t number_of_nodes) noexcept
+    : words_per_row_((number_of_nodes + WORD_BITS - 1) / WORD_BITS),
+      blocks_per_row_((words_per_row_ + WORDS_PER_BLOCK - 1) / WORDS_PER_BLOCK),
+      rows_(number_of_nodes),
+      remaining_in_block_(number_of_nodes),
+      remaining_in_row_(number_of_nodes, 0),
+      remaining_tree_(number_of_nodes),
+      target_mask_(words_per_row_, 0) {}
+
+auto CoverageMatrix::isCovered(graph::Node from, graph::Node to) const noexcept
+    -> bool
+{
+    const auto& row = rows_[from];
+    return row.empty() or (row[wordOf(to)] & bitOf(to)) != 0;
+}
+
+auto CoverageMatrix::isDone(graph::Node from) const noexcept
+    -> bool
+{
+    return remaining_in_row_[from] == 0;
+}
+
+auto CoverageMatrix::done() const noexcept
+    -> bool
+{
+    return remaining_ == 0;
+}
+
+auto CoverageMatrix::remainingIn(graph::Node from) const noexcept
+    -> std::size_t
+{
+    return remaining_in_row_[from];
+}
+
+auto CoverageMatrix::remaining() const noexcept
+    -> std::size_t
+{
+    return remaining_;
+}
+
+auto CoverageMatrix::findUncovered(std::size_t k) const noexcept
+    -> std::pair<graph::Node, graph::Node>
+{
+    const auto from = remaining_tree_.find(static_cast<long long>(k));
+    k -= static_cast<std::size_t>(remaining_tree_.prefixSum(from));
+
+    const auto& row = rows_[from];
+    const auto& blocks = remaining_in_block_[from];
+
+    std::size_t block = 0;
+    while(k >= blocks[block]) {
+        k -= blocks[block++];
+    }
+
+    auto w = block * WORDS_PER_BLOCK;
+    while(true) {
+        const auto uncovered = static_cast<std::size_t>(__builtin_popcountll(~row[w]));
+        if(k < uncovered) {
+            break;
+        }
+        k -= uncovered;
+        w++;
+    }
+
+    //drop the k lowest uncovered bits of the word
+    auto bits = ~row[w];
+    for(; k > 0; k--) {
+        bits &= bits - 1;
+    }
+
+    const auto to = w * WORD_BITS + static_cast<std::size_t>(__builtin_ctzll(bits));
+    return std::pair{static_cast<graph::Node>(from), static_cast<graph::Node>(to)};
+}
+
+auto CoverageMatrix::uncover(graph::Node from, graph::Node to) noexcept
+    -> void
+{
+    auto& row = rows_[from];
+    if(row.empty()) {
+        //the bits behind the last node stay covered forever
+        row.assign(words_per_row_, ALL_COVERED);
+        remaining_in_block_[from].assign(blocks_per_row_, 0);
+    }
+
+    auto& word = row[wordOf(to)];
+    if((word & bitOf(to)) != 0) {
+        word &= ~bitOf(to);
+        remaining_in_block_[from][blockOf(wordOf(to))]++;
+        changeRemaining(from, 1);
+    }
+}
+
+auto CoverageMatrix::cover(graph::Node from, graph::Node to) noexcept
+    -> void
+{
+    if(isCovered(from, to)) {
+        return;
+    }
+
+    rows_[from][wordOf(to)] |= bitOf(to);
+    remaining_in_block_[from][blockOf(wordOf(to))]--;
+    changeRemaining(from, -1);
+
+    freeIfDone(from);
+}
+
+auto CoverageMatrix::addToTargetMask(graph::Node target) noexcept
+    -> void
+{
+    auto& word = target_mask_[wordOf(target)];
+    if(word == 0) {
+        mask_words_.emplace_back(wordOf(target));
+    }
+    word |= bitOf(target);
+}
+
+auto CoverageMatrix::coverMaskedTargetsOf(graph::Node source) noexcept
+    -> std::size_t
+{
+    auto& row = rows_[source];
+    if(row.empty()) {
+        return 0;
+    }
+
+    auto& blocks = remaining_in_block_[source];
+    long long newly_covered = 0;
+    for(auto w : mask_words_) {
+        const auto covered_in_word = __builtin_popcountll(target_mask_[w] & ~row[w]);
+        row[w] |= target_mask_[w];
+        blocks[blockOf(w)] -= covered_in_word;
+        newly_covered += covered_in_word;
+    }
+
+    if(newly_covered > 0) {
+        changeRemaining(source, -newly_covered);
+    }
+
+    freeIfDone(source);
+
+    return static_cast<std::size_t>(newly_covered);
+}
+
+auto CoverageMatrix::clearTargetMask() noexcept
+    -> void
+{
+    for(auto w : mask_words_) {
+        target_mask_[w] = 0;
+    }
+    mask_words_.clear();
+}
+
+auto CoverageMatrix::wordOf(graph::Node n) noexcept
+    -> std::size_t
+{
+    return n / WORD_BITS;
+}
+
+auto CoverageMatrix::bitOf(graph::Node n) noexcept
+    -> std::uint64_t
+{
+    return std::uint64_t{1} << (n % WORD_BITS);
+}
+
+auto CoverageMatrix::blockOf(std::size_t word) noexcept
+    -> std::size_t
+{
+    return word / WORDS_PER_BLOCK;
+}
+
+auto CoverageMatrix::changeRemaining(graph::Node from, long long delta) noexcept
+    -> void
+{
+    remaining_in_row_[from] += delta;
+    remaining_ += delta;
+    remaining_tree_.add(from, delta);
+}
+
+auto CoverageMatrix::freeIfDone(graph::Node from) noexcept
+    -> void
+{
+    if(remaining_in_row_[from] == 0) {
+        utils::cleanAndFree(rows_[from]);
+        utils::cleanAndFree(remaining_in_block_[from]);
+    }
+}
@@ -0,0 +1,190 @@
+#include <filesystem>
+#include <fmt/core.h>
+#include <fmt/format.h>
+#include <fstream>
+#include <graph/Graph.hpp>
+#include <iterator>
+#include <selection/GeoJsonExport.hpp>
+#include <selection/SelectionStore.hpp>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <utils/Range.hpp>
+#include <utils/Utils.hpp>
+
+using selection::GeoJsonLayout;
+using selection::GeoJsonOptions;
+using selection::GeoJsonWriter;
+using selection::PatchView;
+
+namespace {
+
+auto separatorOf(GeoJsonLayout layout) noexcept
+    -> std::string_view
+{
+    return layout == GeoJsonLayout::FEATURE_COLLECTION ? ",\n" : "\n";
+}
+
+auto appendCoordinates(fmt::memory_buffer& buffer,
+                       const graph::Graph& graph,
+                       graph::Node node,
+                       const GeoJsonOptions& options) noexcept
+    -> void
+{
+    //GeoJSON positions are longitude first
+    const auto [lat, lng] = graph.getLatLng(node);
+    auto out = std::back_inserter(buffer);
+
+    if(options.decimals) {
+        const auto decimals = options.decimals.value();
+        fmt::format_to(out, "[{:.{}f},{:.{}f}]", lng, decimals, lat, decimals);
+    } else {
+        fmt::format_to(out, "[{},{}]", lng, lat);
+    }
+}
+
+auto appendFeatureBegin(fmt::memory_buffer& buffer,
+                        const selection::SelectionView& selection,
+                        std::size_t index,
+                        std::string_view role,
+                        std::string_view geometry,
+                        const GeoJsonOptions& options) noexcept
+    -> void
+{
+    if(buffer.size() != 0) {
+        const auto separator = separatorOf(options.layout);
+        buffer.append(separator.data(), separator.data() + separator.size());
+    }
+
+    fmt::format_to(std::back_inserter(buffer),
+                   R"({{"type":"Feature","properties":{{"selection":{},"role":"{}","center":{},"inverse_valid":{}}},)"
+                   R"("geometry":{{"type":"{}","coordinates":)",
+                   index,
+                   role,
+                   selection.getCenter(),
+                   selection.isInverseValid(),
+                   geometry);
+}
+
+auto appendPatchFeature(fmt::memory_buffer& buffer,
+                        const graph::Graph& graph,
+                        const selection::SelectionView& selection,
+                        const PatchView& patch,
+                        std::size_t index,
+                        std::string_view role,
+                        const GeoJsonOptions& options) noexcept
+    -> void
+{
+    appendFeatureBegin(buffer, selection, index, role, "MultiPoint", options);
+
+    buffer.push_back('[');
+    for(auto i : utils::range(patch.size())) {
+        if(i != 0) {
+            buffer.push_back(',');
+        }
+        appendCoordinates(buffer, graph, patch[i].first, options);
+    }
+
+    constexpr std::string_view end = "]}}";
+    buffer.append(end.data(), end.data() + end.size());
+}
+
+} // namespace
+
+auto selection::appendGeoJsonFeatures(fmt::memory_buffer& buffer,
+                                      const graph::Graph& graph,
+                                      const SelectionView& selection,
+                                      std::size_t index,
+                                      const GeoJsonOptions& options) noexcept
+    -> void
+{
+    appendPatchFeature(buffer,
+                       graph,
+                       selection,
+                       selection.getSourcePatch(),
+                       index,
+                       "sources",
+                       options);
+
+    appendPatchFeature(buffer,
+                       graph,
+                       selection,
+                       selection.getTargetPatch(),
+                       index,
+                       "targets",
+                       options);
+
+    appendFeatureBegin(buffer, selection, index, "center", "Point", options);
+    appendCoordinates(buffer, graph, selection.getCenter(), options);
+
+    constexpr std::string_view end = "}}";
+    buffer.append(end.data(), end.data() + end.size());
+}
+
+GeoJsonWriter::GeoJsonWriter(std::string path,
+                             GeoJsonOptions options) noexcept
+    : path_(std::move(path)),
+      tmp_path_(utils::temporaryPathOf(path_)),
+      options_(options),
+      file_(tmp_path_)
+{
+    if(!file_) {
+        fmt::print(stderr, "unable to open file {}\n", tmp_path_);
+        return;
+    }
+
+    if(options_.layout == GeoJsonLayout::FEATURE_COLLECTION) {
+        file_ << R"({"type":"FeatureCollection","features":[)" << '\n';
+    }
+}
+
+GeoJsonWriter::~GeoJsonWriter() noexcept
+{
+    if(!finished_) {
+        file_.close();
+        std::error_code error;
+        std::filesystem::remove(tmp_path_, error);
+    }
+}
+
+auto GeoJsonWriter::writeChunk(const fmt::memory_buffer& buffer) noexcept
+    -> void
+{
+    if(buffer.size() == 0) {
+        return;
+    }
+
+    if(!is_empty_) {
+        file_ << separatorOf(options_.layout);
+    }
+
+    file_.write(buffer.data(), buffer.size());
+    is_empty_ = false;
+}
+
+auto GeoJsonWriter::finish() noexcept
+    -> bool
+{
+    if(options_.layout == GeoJsonLayout::FEATURE_COLLECTION) {
+        file_ << "\n]}\n";
+    } else if(!is_empty_) {
+        file_ << '\n';
+    }
+
+    file_.close();
+
+    if(!file_) {
+        fmt::print(stderr, "unable to write file {}\n", tmp_path_);
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tmp_path_, path_, error);
+    if(error) {
+        fmt::print(stderr, "unable to move file {} to {}\n", tmp_path_, path_);
+        return false;
+    }
+
+    finished_ = true;
+    return true;
+}
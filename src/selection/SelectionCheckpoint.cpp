@@ -0,0 +1,452 @@
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fmt/core.h>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <selection/NodeSelection.hpp>
+#include <selection/SelectionStore.hpp>
+#include <selection/SelectionCheckpoint.hpp>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <unistd.h>
+#include <utils/Utils.hpp>
+#include <vector>
+
+using selection::CheckpointWriter;
+using selection::SelectionCheckpoint;
+
+namespace {
+
+constexpr auto FILE_MAGIC = std::uint64_t{0x544e494f504b4843}; // "CHKPOINT"
+constexpr auto FILE_VERSION = std::uint64_t{2};
+
+struct FileHeader
+{
+    std::uint64_t magic;
+    std::uint64_t version;
+    std::uint64_t number_of_nodes;
+    std::uint64_t fingerprint;
+    std::int64_t prune_distance;
+    std::uint64_t random_state_size;
+    std::uint64_t number_of_records;
+};
+
+//every record starts with its type as 32 bit value
+enum class RecordType : std::uint32_t {
+    // center, inverse flag, source patch and target patch of a selection
+    SELECTION = 0,
+    // the two nodes of a seed pair which was covered without a selection
+    COVERED_PAIR = 1
+};
+
+//a patch entry is stored as 32 bit node followed by its distance, without padding
+constexpr auto PATCH_ENTRY_SIZE = sizeof(std::uint32_t) + sizeof(graph::Distance);
+
+template<class T>
+auto append(std::vector<char>& bytes, const T* values, std::size_t count) noexcept
+    -> void
+{
+    const auto* begin = reinterpret_cast<const char*>(values);
+    bytes.insert(std::end(bytes), begin, begin + count * sizeof(T));
+}
+
+template<class T>
+auto append(std::vector<char>& bytes, const T& value) noexcept
+    -> void
+{
+    append(bytes, &value, 1);
+}
+
+auto appendPatch(std::vector<char>& bytes, const selection::PatchView& patch) noexcept
+    -> void
+{
+    append(bytes, static_cast<std::uint64_t>(patch.size()));
+    for(auto [node, distance] : patch) {
+        append(bytes, static_cast<std::uint32_t>(node));
+        append(bytes, distance);
+    }
+}
+
+// reads values from the bytes of a file, every read fails once
+// the end of the file was passed
+class ByteReader
+{
+public:
+    explicit ByteReader(const std::vector<char>& bytes) noexcept
+        : bytes_(bytes) {}
+
+    [[nodiscard]] auto remaining() const noexcept
+        -> std::size_t
+    {
+        return bytes_.size() - position_;
+    }
+
+    template<class T>
+    auto read(T* values, std::size_t count) noexcept
+        -> bool
+    {
+        const auto size = count * sizeof(T);
+        if(remaining() < size) {
+            return false;
+        }
+
+        std::memcpy(values, bytes_.data() + position_, size);
+        position_ += size;
+        return true;
+    }
+
+    template<class T>
+    auto read(T& value) noexcept
+        -> bool
+    {
+        return read(&value, 1);
+    }
+
+    auto readPatch(selection::Patch& patch) noexcept
+        -> bool
+    {
+        std::uint64_t size;
+        if(!read(size) or size > remaining() / PATCH_ENTRY_SIZE) {
+            return false;
+        }
+
+        patch.reserve(size);
+        for(std::uint64_t i = 0; i < size; i++) {
+            std::uint32_t node = 0;
+            graph::Distance distance = 0;
+            read(node);
+            read(distance);
+            patch.emplace_back(node, distance);
+        }
+
+        return true;
+    }
+
+private:
+    const std::vector<char>& bytes_;
+    std::size_t position_ = 0;
+};
+
+auto readFile(std::string_view path) noexcept
+    -> std::optional<std::vector<char>>
+{
+    std::ifstream file{std::string{path}, std::ios::binary};
+    if(!file) {
+        return std::nullopt;
+    }
+
+    std::vector<char> bytes{std::istreambuf_iterator<char>{file},
+                            std::istreambuf_iterator<char>{}};
+
+    if(file.bad()) {
+        return std::nullopt;
+    }
+
+    return bytes;
+}
+
+// copies the bytes at the offset of the input to the end of the output
+auto copyBytes(std::ifstream& input,
+               std::size_t offset,
+               std::size_t size,
+               std::ofstream& output) noexcept
+    -> bool
+{
+    std::vector<char> chunk(std::min(size, std::size_t{1} << 20));
+
+    input.seekg(static_cast<std::streamoff>(offset));
+    while(size > 0 and input) {
+        const auto chunk_size = std::min(size, chunk.size());
+        input.read(chunk.data(), static_cast<std::streamsize>(chunk_size));
+        output.write(chunk.data(), static_cast<std::streamsize>(chunk_size));
+        size -= chunk_size;
+    }
+
+    return static_cast<bool>(input);
+}
+
+// forces the content of the file to the disk, the stream which wrote
+// it was closed before, but its data can still be in the page cache
+auto syncFile(const std::string& path) noexcept
+    -> bool
+{
+    const auto fd = ::open(path.c_str(), O_WRONLY);
+    if(fd < 0) {
+        return false;
+    }
+
+    const auto synced = fsync(fd) == 0;
+    close(fd);
+
+    return synced;
+}
+
+} // namespace
+
+CheckpointWriter::CheckpointWriter(std::string path,
+                                   std::uint64_t fingerprint,
+                                   std::size_t number_of_nodes,
+                                   graph::Distance prune_distance) noexcept
+    : path_(std::move(path)),
+      fingerprint_(fingerprint),
+      number_of_nodes_(number_of_nodes),
+      prune_distance_(prune_distance),
+      writer_([this] { writeInBackground(); }) {}
+
+CheckpointWriter::~CheckpointWriter() noexcept
+{
+    {
+        std::lock_guard lock{mutex_};
+        stopping_ = true;
+    }
+
+    wake_up_.notify_one();
+    writer_.join();
+}
+
+auto CheckpointWriter::addSelection(const SelectionView& selection) noexcept
+    -> void
+{
+    append(new_records_, RecordType::SELECTION);
+    append(new_records_, static_cast<std::uint32_t>(selection.getCenter()));
+    append(new_records_, static_cast<std::uint32_t>(selection.isInverseValid()));
+    appendPatch(new_records_, selection.getSourcePatch());
+    appendPatch(new_records_, selection.getTargetPatch());
+    number_of_records_++;
+}
+
+auto CheckpointWriter::addCoveredPair(graph::Node first, graph::Node second) noexcept
+    -> void
+{
+    append(new_records_, RecordType::COVERED_PAIR);
+    append(new_records_, static_cast<std::uint32_t>(first));
+    append(new_records_, static_cast<std::uint32_t>(second));
+    number_of_records_++;
+}
+
+auto CheckpointWriter::takeCheckpoint(std::string_view random_state) noexcept
+    -> void
+{
+    std::vector<char> state;
+    state.reserve(sizeof(FileHeader) + random_state.size());
+
+    append(state,
+           FileHeader{FILE_MAGIC,
+                      FILE_VERSION,
+                      number_of_nodes_,
+                      fingerprint_,
+                      prune_distance_,
+                      random_state.size(),
+                      number_of_records_});
+
+    append(state, random_state.data(), random_state.size());
+
+    {
+        std::lock_guard lock{mutex_};
+        if(pending_) {
+            //the waiting checkpoint is replaced, its records are not written yet
+            auto& pending = pending_.value();
+            pending.new_records.insert(std::end(pending.new_records),
+                                       std::begin(new_records_),
+                                       std::end(new_records_));
+            new_records_.clear();
+            pending.state = std::move(state);
+        } else {
+            pending_ = PendingCheckpoint{std::move(state),
+                                         std::exchange(new_records_, {})};
+        }
+    }
+
+    wake_up_.notify_one();
+}
+
+auto CheckpointWriter::writeInBackground() noexcept
+    -> void
+{
+    std::unique_lock lock{mutex_};
+
+    while(true) {
+        wake_up_.wait(lock, [&] {
+            return pending_ or stopping_;
+        });
+
+        if(!pending_) {
+            return;
+        }
+
+        auto checkpoint = std::move(pending_.value());
+        pending_.reset();
+
+        lock.unlock();
+
+        //the records of a failed write are written with the next checkpoint
+        if(unwritten_records_.empty()) {
+            unwritten_records_ = std::move(checkpoint.new_records);
+        } else {
+            unwritten_records_.insert(std::end(unwritten_records_),
+                                      std::begin(checkpoint.new_records),
+                                      std::end(checkpoint.new_records));
+        }
+
+        if(writeFile(checkpoint.state, unwritten_records_)) {
+            written_records_offset_ = checkpoint.state.size();
+            written_records_size_ += unwritten_records_.size();
+            unwritten_records_.clear();
+        } else {
+            fmt::print(stderr, "unable to write checkpoint {}\n", path_);
+        }
+
+        lock.lock();
+    }
+}
+
+auto CheckpointWriter::writeFile(const std::vector<char>& state,
+                                 const std::vector<char>& new_records) const noexcept
+    -> bool
+{
+    //written next to the final file and renamed, such that
+    //an interrupted run never leaves a truncated file behind
+    const auto tmp_path = utils::temporaryPathOf(path_);
+
+    std::ofstream file{tmp_path, std::ios::binary};
+    if(!file) {
+        return false;
+    }
+
+    file.write(state.data(), state.size());
+
+    if(written_records_size_ > 0) {
+        std::ifstream previous{path_, std::ios::binary};
+        if(!copyBytes(previous, written_records_offset_, written_records_size_, file)) {
+            file.close();
+            std::error_code error;
+            std::filesystem::remove(tmp_path, error);
+            return false;
+        }
+    }
+
+    file.write(new_records.data(), new_records.size());
+    file.close();
+
+    std::error_code error;
+    if(!file or !syncFile(tmp_path)) {
+        std::filesystem::remove(tmp_path, error);
+        return false;
+    }
+
+    std::filesystem::rename(tmp_path, path_, error);
+
+    return !error;
+}
+
+auto selection::loadCheckpoint(std::string_view path,
+                               std::uint64_t fingerprint,
+                               std::size_t number_of_nodes,
+                               graph::Distance prune_distance) noexcept
+    -> std::optional<SelectionCheckpoint>
+{
+    auto bytes_opt = readFile(path);
+    if(!bytes_opt) {
+        return std::nullopt;
+    }
+
+    const auto& bytes = bytes_opt.value();
+    ByteReader reader{bytes};
+
+    FileHeader header;
+    if(!reader.read(header)
+       or header.magic != FILE_MAGIC
+       or header.version != FILE_VERSION
+       or header.number_of_nodes != number_of_nodes
+       or header.fingerprint != fingerprint
+       or header.prune_distance != prune_distance) {
+        fmt::print(stderr, "checkpoint {} does not belong to this graph and prune distance\n", path);
+        return std::nullopt;
+    }
+
+    if(header.random_state_size > reader.remaining()) {
+        fmt::print(stderr, "checkpoint {} is truncated\n", path);
+        return std::nullopt;
+    }
+
+    SelectionCheckpoint checkpoint;
+    checkpoint.random_state.resize(header.random_state_size);
+    if(!reader.read(checkpoint.random_state.data(), checkpoint.random_state.size())) {
+        fmt::print(stderr, "checkpoint {} is truncated\n", path);
+        return std::nullopt;
+    }
+
+    //the nodes of the records are checked, they are used as indices into the coverage
+    const auto is_node = [&](auto node) {
+        return node < number_of_nodes;
+    };
+
+    Patch sources;
+    Patch targets;
+    for(std::uint64_t i = 0; i < header.number_of_records; i++) {
+        RecordType type;
+        if(!reader.read(type)) {
+            fmt::print(stderr, "checkpoint {} is truncated\n", path);
+            return std::nullopt;
+        }
+
+        if(type == RecordType::COVERED_PAIR) {
+            std::uint32_t first;
+            std::uint32_t second;
+            if(!reader.read(first) or !reader.read(second)) {
+                fmt::print(stderr, "checkpoint {} is truncated\n", path);
+                return std::nullopt;
+            }
+
+            if(!is_node(first) or !is_node(second)) {
+                fmt::print(stderr, "checkpoint {} is corrupted\n", path);
+                return std::nullopt;
+            }
+
+            checkpoint.covered_pairs.emplace_back(first, second);
+            continue;
+        }
+
+        if(type != RecordType::SELECTION) {
+            fmt::print(stderr, "checkpoint {} is corrupted\n", path);
+            return std::nullopt;
+        }
+
+        std::uint32_t center;
+        std::uint32_t is_inverse_valid;
+        sources.clear();
+        targets.clear();
+
+        if(!reader.read(center)
+           or !reader.read(is_inverse_valid)
+           or !reader.readPatch(sources)
+           or !reader.readPatch(targets)) {
+            fmt::print(stderr, "checkpoint {} is truncated\n", path);
+            return std::nullopt;
+        }
+
+        const auto patch_is_valid = [&](const auto& patch) {
+            return std::all_of(std::begin(patch),
+                               std::end(patch),
+                               [&](const auto& entry) {
+                                   return is_node(entry.first);
+                               });
+        };
+
+        if(!is_node(center) or !patch_is_valid(sources) or !patch_is_valid(targets)) {
+            fmt::print(stderr, "checkpoint {} is corrupted\n", path);
+            return std::nullopt;
+        }
+
+        checkpoint.selections.add(sources,
+                                  targets,
+                                  center,
+                                  is_inverse_valid != 0);
+    }
+
+    return checkpoint;
+}
@@ -0,0 +1,354 @@
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fmt/core.h>
+#include <fstream>
+#include <graph/Graph.hpp>
+#include <optional>
+#include <selection/NodeSelection.hpp>
+#include <selection/SelectionFile.hpp>
+#include <selection/SelectionStore.hpp>
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+#include <utils/Utils.hpp>
+#include <vector>
+
+using selection::PatchView;
+using selection::SelectionFile;
+using selection::SelectionFileWriter;
+using selection::SelectionView;
+
+namespace {
+
+constexpr auto FILE_MAGIC = std::uint64_t{0x5453544c45534547}; // "GESELTST"
+constexpr auto FILE_VERSION = std::uint64_t{2};
+
+// the header fills a whole page, such that the mapped patches keep their alignment
+constexpr auto HEADER_SIZE = std::size_t{4096};
+
+struct FileHeader
+{
+    std::uint64_t magic;
+    std::uint64_t version;
+    std::uint64_t entry_size;
+    std::uint64_t number_of_nodes;
+    std::uint64_t fingerprint;
+    std::int64_t prune_distance;
+    std::uint64_t number_of_selections;
+    std::uint64_t table_offset;
+};
+
+static_assert(sizeof(FileHeader) <= HEADER_SIZE);
+
+struct TableEntry
+{
+    std::uint64_t offset;
+    std::uint32_t number_of_sources;
+    std::uint32_t number_of_targets;
+    std::uint32_t center;
+    std::uint32_t is_inverse_valid;
+};
+
+// the nodes and the distances of a selection both start at a multiple of 8 bytes
+constexpr auto BLOCK_ALIGNMENT = std::size_t{8};
+
+constexpr auto padded(std::size_t size) noexcept
+    -> std::size_t
+{
+    return (size + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT * BLOCK_ALIGNMENT;
+}
+
+constexpr auto nodesSize(std::size_t number_of_entries) noexcept
+    -> std::size_t
+{
+    return padded(number_of_entries * sizeof(std::uint32_t));
+}
+
+constexpr auto blockSize(std::size_t number_of_entries) noexcept
+    -> std::size_t
+{
+    return nodesSize(number_of_entries)
+        + padded(number_of_entries * sizeof(graph::Distance));
+}
+
+} // namespace
+
+SelectionFileWriter::SelectionFileWriter(std::string path,
+                                         std::uint64_t fingerprint,
+                                         std::size_t number_of_nodes,
+                                         graph::Distance prune_distance) noexcept
+    : path_(std::move(path)),
+      tmp_path_(utils::temporaryPathOf(path_)),
+      file_(tmp_path_, std::ios::binary),
+      fingerprint_(fingerprint),
+      number_of_nodes_(number_of_nodes),
+      prune_distance_(prune_distance)
+{
+    if(!file_) {
+        fmt::print(stderr, "unable to open file {}\n", tmp_path_);
+        return;
+    }
+
+    //the header is written by finish, once the table offset is known
+    const std::vector<char> header_page(HEADER_SIZE, 0);
+    write(header_page.data(), header_page.size());
+}
+
+SelectionFileWriter::~SelectionFileWriter() noexcept
+{
+    if(!finished_) {
+        file_.close();
+        std::error_code error;
+        std::filesystem::remove(tmp_path_, error);
+    }
+}
+
+auto SelectionFileWriter::add(const SelectionView& selection) noexcept
+    -> void
+{
+    add(selection.getSourcePatch(),
+        selection.getTargetPatch(),
+        selection.getCenter(),
+        selection.isInverseValid());
+}
+
+auto SelectionFileWriter::add(const NodeSelection& selection) noexcept
+    -> void
+{
+    add(selection.getSourcePatch(),
+        selection.getTargetPatch(),
+        selection.getCenter(),
+        selection.isInverseValid());
+}
+
+template<class SourcePatch, class TargetPatch>
+auto SelectionFileWriter::add(const SourcePatch& sources,
+                              const TargetPatch& targets,
+                              graph::Node center,
+                              bool is_inverse_valid) noexcept
+    -> void
+{
+    nodes_.clear();
+    distances_.clear();
+
+    for(auto [node, distance] : sources) {
+        nodes_.emplace_back(static_cast<std::uint32_t>(node));
+        distances_.emplace_back(distance);
+    }
+    for(auto [node, distance] : targets) {
+        nodes_.emplace_back(static_cast<std::uint32_t>(node));
+        distances_.emplace_back(distance);
+    }
+
+    const TableEntry entry{position_,
+                           static_cast<std::uint32_t>(sources.size()),
+                           static_cast<std::uint32_t>(targets.size()),
+                           static_cast<std::uint32_t>(center),
+                           is_inverse_valid};
+
+    const auto* entry_bytes = reinterpret_cast<const char*>(&entry);
+    table_.insert(std::end(table_), entry_bytes, entry_bytes + sizeof(entry));
+    number_of_selections_++;
+
+    const char padding[BLOCK_ALIGNMENT] = {};
+    const auto nodes_bytes = nodes_.size() * sizeof(std::uint32_t);
+    const auto distances_bytes = distances_.size() * sizeof(graph::Distance);
+
+    write(reinterpret_cast<const char*>(nodes_.data()), nodes_bytes);
+    write(padding, padded(nodes_bytes) - nodes_bytes);
+    write(reinterpret_cast<const char*>(distances_.data()), distances_bytes);
+    write(padding, padded(distances_bytes) - distances_bytes);
+}
+
+auto SelectionFileWriter::finish() noexcept
+    -> bool
+{
+    const auto table_offset = position_;
+    write(table_.data(), table_.size());
+
+    FileHeader header{FILE_MAGIC,
+                      FILE_VERSION,
+                      sizeof(graph::Distance),
+                      number_of_nodes_,
+                      fingerprint_,
+                      prune_distance_,
+                      number_of_selections_,
+                      table_offset};
+
+    file_.seekp(0);
+    file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file_.close();
+
+    if(!file_) {
+        fmt::print(stderr, "unable to write file {}\n", tmp_path_);
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tmp_path_, path_, error);
+    if(error) {
+        fmt::print(stderr, "unable to move file {} to {}\n", tmp_path_, path_);
+        return false;
+    }
+
+    finished_ = true;
+    return true;
+}
+
+auto SelectionFileWriter::write(const char* bytes, std::size_t size) noexcept
+    -> void
+{
+    file_.write(bytes, size);
+    position_ += size;
+}
+
+auto SelectionFile::MappingDelete::operator()(const char* mapping) const noexcept
+    -> void
+{
+    munmap(const_cast<char*>(mapping), mapped_bytes);
+}
+
+SelectionFile::SelectionFile(const char* mapping,
+                             std::size_t mapped_bytes,
+                             std::size_t number_of_selections,
+                             std::size_t table_offset) noexcept
+    : mapping_(mapping, MappingDelete{mapped_bytes}),
+      number_of_selections_(number_of_selections),
+      table_offset_(table_offset) {}
+
+auto SelectionFile::open(std::string_view path,
+                         std::uint64_t fingerprint,
+                         std::size_t number_of_nodes,
+                         graph::Distance prune_distance) noexcept
+    -> std::optional<SelectionFile>
+{
+    auto fd = ::open(std::string{path}.c_str(), O_RDONLY);
+    if(fd < 0) {
+        fmt::print(stderr, "unable to open file {}\n", path);
+        return std::nullopt;
+    }
+
+    struct stat file_stat;
+    if(fstat(fd, &file_stat) != 0
+       or static_cast<std::size_t>(file_stat.st_size) < HEADER_SIZE) {
+        fmt::print(stderr, "selection file {} is truncated\n", path);
+        close(fd);
+        return std::nullopt;
+    }
+
+    const auto file_size = static_cast<std::size_t>(file_stat.st_size);
+    auto* mapping = static_cast<const char*>(
+        mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0));
+    close(fd);
+
+    if(mapping == MAP_FAILED) {
+        fmt::print(stderr, "unable to map file {}\n", path);
+        return std::nullopt;
+    }
+
+    SelectionFile file{mapping, file_size, 0, 0};
+
+    FileHeader header;
+    std::memcpy(&header, mapping, sizeof(header));
+
+    if(header.magic != FILE_MAGIC
+       or header.version != FILE_VERSION
+       or header.entry_size != sizeof(graph::Distance)) {
+        fmt::print(stderr, "selection file {} was written in another format\n", path);
+        return std::nullopt;
+    }
+
+    if(header.number_of_nodes != number_of_nodes
+       or header.fingerprint != fingerprint
+       or header.prune_distance != prune_distance) {
+        fmt::print(stderr, "selection file {} does not belong to this graph and prune distance\n", path);
+        return std::nullopt;
+    }
+
+    if(header.table_offset < HEADER_SIZE
+       or header.table_offset > file_size
+       or (file_size - header.table_offset) / sizeof(TableEntry) != header.number_of_selections
+       or (file_size - header.table_offset) % sizeof(TableEntry) != 0) {
+        fmt::print(stderr, "selection file {} is corrupted\n", path);
+        return std::nullopt;
+    }
+
+    //the node ids of the patches index the arrays of the optimizer and are
+    //checked with the table, the distances are not read before they are used
+    for(std::size_t i = 0; i < header.number_of_selections; i++) {
+        TableEntry entry;
+        std::memcpy(&entry,
+                    mapping + header.table_offset + i * sizeof(TableEntry),
+                    sizeof(entry));
+
+        const auto number_of_entries = std::size_t{entry.number_of_sources}
+            + entry.number_of_targets;
+
+        if(entry.offset < HEADER_SIZE
+           or entry.offset % BLOCK_ALIGNMENT != 0
+           or entry.offset > header.table_offset
+           or blockSize(number_of_entries) > header.table_offset - entry.offset
+           or entry.center >= number_of_nodes) {
+            fmt::print(stderr, "selection file {} is corrupted\n", path);
+            return std::nullopt;
+        }
+
+        const auto* nodes = reinterpret_cast<const std::uint32_t*>(mapping + entry.offset);
+        const auto is_node = [&](auto node) {
+            return node < number_of_nodes;
+        };
+
+        if(!std::all_of(nodes, nodes + number_of_entries, is_node)) {
+            fmt::print(stderr, "selection file {} is corrupted\n", path);
+            return std::nullopt;
+        }
+    }
+
+    file.number_of_selections_ = header.number_of_selections;
+    file.table_offset_ = header.table_offset;
+
+    return file;
+}
+
+auto SelectionFile::operator[](std::size_t index) const noexcept
+    -> SelectionView
+{
+    TableEntry entry;
+    std::memcpy(&entry,
+                mapping_.get() + table_offset_ + index * sizeof(TableEntry),
+                sizeof(entry));
+
+    const auto number_of_entries = std::size_t{entry.number_of_sources}
+        + entry.number_of_targets;
+
+    const auto* nodes = reinterpret_cast<const std::uint32_t*>(
+        mapping_.get() + entry.offset);
+    const auto* distances = reinterpret_cast<const graph::Distance*>(
+        mapping_.get() + entry.offset + nodesSize(number_of_entries));
+
+    return SelectionView{PatchView{nodes,
+                                   distances,
+                                   entry.number_of_sources},
+                         PatchView{nodes + entry.number_of_sources,
+                                   distances + entry.number_of_sources,
+                                   entry.number_of_targets},
+                         entry.center,
+                         entry.is_inverse_valid != 0};
+}
+
+auto SelectionFile::size() const noexcept
+    -> std::size_t
+{
+    return number_of_selections_;
+}
+
+auto SelectionFile::empty() const noexcept
+    -> bool
+{
+    return number_of_selections_ == 0;
+}
@@ -0,0 +1,109 @@
+#include <graph/Graph.hpp>
+#include <selection/NodeSelection.hpp>
+#include <selection/SelectionStore.hpp>
+#include <vector>
+
+using selection::NodeSelection;
+using selection::SelectionStore;
+using selection::SelectionView;
+
+auto SelectionView::toNodeSelection() const noexcept
+    -> NodeSelection
+{
+    Patch sources(std::begin(source_patch_), std::end(source_patch_));
+    Patch targets(std::begin(target_patch_), std::end(target_patch_));
+
+    return NodeSelection{std::move(sources),
+                         std::move(targets),
+                         center_,
+                         is_inverse_valid_};
+}
+
+auto SelectionStore::add(const SelectionView& selection) noexcept
+    -> void
+{
+    add(selection.getSourcePatch(),
+        selection.getTargetPatch(),
+        selection.getCenter(),
+        selection.isInverseValid());
+}
+
+auto SelectionStore::add(const NodeSelection& selection) noexcept
+    -> void
+{
+    add(selection.getSourcePatch(),
+        selection.getTargetPatch(),
+        selection.getCenter(),
+        selection.isInverseValid());
+}
+
+auto SelectionStore::removeLast() noexcept
+    -> void
+{
+    nodes_.resize(records_.back().begin);
+    distances_.resize(records_.back().begin);
+    records_.pop_back();
+}
+
+auto SelectionStore::clear() noexcept
+    -> void
+{
+    nodes_.clear();
+    distances_.clear();
+    records_.clear();
+}
+
+auto SelectionStore::operator[](std::size_t index) const noexcept
+    -> SelectionView
+{
+    const auto& record = records_[index];
+    const auto targets_begin = record.begin + record.number_of_sources;
+
+    return SelectionView{PatchView{nodes_.data() + record.begin,
+                                   distances_.data() + record.begin,
+                                   record.number_of_sources},
+                         PatchView{nodes_.data() + targets_begin,
+                                   distances_.data() + targets_begin,
+                                   record.number_of_targets},
+                         record.center,
+                         record.is_inverse_valid};
+}
+
+auto SelectionStore::back() const noexcept
+    -> SelectionView
+{
+    return (*this)[records_.size() - 1];
+}
+
+auto SelectionStore::size() const noexcept
+    -> std::size_t
+{
+    return records_.size();
+}
+
+auto SelectionStore::empty() const noexcept
+    -> bool
+{
+    return records_.empty();
+}
+
+auto SelectionStore::compacted(const std::vector<std::size_t>& order) const noexcept
+    -> SelectionStore
+{
+    std::size_t number_of_entries = 0;
+    for(auto index : order) {
+        const auto& record = records_[index];
+        number_of_entries += record.number_of_sources + record.number_of_targets;
+    }
+
+    SelectionStore store;
+    store.nodes_.reserve(number_of_entries);
+    store.distances_.reserve(number_of_entries);
+    store.records_.reserve(order.size());
+
+    for(auto index : order) {
+        store.add((*this)[index]);
+    }
+
+    return store;
+}
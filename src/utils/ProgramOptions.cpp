@@ -1,4 +1,5 @@
 #include <CLI/CLI.hpp>
+#include <map>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -11,11 +12,51 @@ using utils::ProgramOptions;
 ProgramOptions::ProgramOptions(graph::Distance prune_distance,
                                std::string graph_file,
                                std::size_t maximum_number_of_selections_per_node,
-                               std::optional<std::string> result_folder)
+                               std::optional<std::string> result_folder,
+                               std::optional<std::string> cache_folder,
+                               bool compress_distances,
+                               bool transposed_copy,
+                               std::optional<std::size_t> lazy_cache_budget,
+                               bool record_predecessors,
+                               std::optional<std::size_t> candidate_failure_limit,
+                               std::optional<graph::Distance> candidate_radius,
+                               std::optional<std::uint64_t> seed,
+                               bool parallel_selection,
+                               bool farthest_first,
+                               CenterChoice center_choice,
+                               std::optional<std::size_t> checkpoint_interval,
+                               bool resume,
+                               std::optional<std::string> selections_to_save,
+                               std::optional<std::string> selections_to_load,
+                               std::optional<std::string> geojson_file,
+                               bool geojson_lines,
+                               std::optional<int> geojson_decimals,
+                               std::optional<std::size_t> geojson_limit,
+                               bool verify_answers)
     : prune_distance_(prune_distance),
       graph_file_(std::move(graph_file)),
       maximum_number_of_selections_per_node_(maximum_number_of_selections_per_node),
-      separation_folder_(std::move(result_folder)) {}
+      separation_folder_(std::move(result_folder)),
+      cache_folder_(std::move(cache_folder)),
+      compress_distances_(compress_distances),
+      transposed_copy_(transposed_copy),
+      lazy_cache_budget_(lazy_cache_budget),
+      record_predecessors_(record_predecessors),
+      candidate_failure_limit_(candidate_failure_limit),
+      candidate_radius_(candidate_radius),
+      seed_(seed),
+      parallel_selection_(parallel_selection),
+      farthest_first_(farthest_first),
+      center_choice_(center_choice),
+      checkpoint_interval_(checkpoint_interval),
+      resume_(resume),
+      selections_to_save_(std::move(selections_to_save)),
+      selections_to_load_(std::move(selections_to_load)),
+      geojson_file_(std::move(geojson_file)),
+      geojson_lines_(geojson_lines),
+      geojson_decimals_(geojson_decimals),
+      geojson_limit_(geojson_limit),
+      verify_answers_(verify_answers) {}
 
 auto ProgramOptions::getGraphFile() const noexcept
     -> std::string_view
@@ -36,6 +77,162 @@ auto ProgramOptions::getResultFolder() const noexcept
     return separation_folder_.value();
 }
 
+auto ProgramOptions::hasCacheFolder() const noexcept
+    -> bool
+{
+    return !!cache_folder_;
+}
+
+auto ProgramOptions::getCacheFolder() const noexcept
+    -> std::string_view
+{
+    return cache_folder_.value();
+}
+
+auto ProgramOptions::compressDistances() const noexcept
+    -> bool
+{
+    return compress_distances_;
+}
+
+auto ProgramOptions::keepTransposedCopy() const noexcept
+    -> bool
+{
+    return transposed_copy_;
+}
+
+auto ProgramOptions::recordPredecessors() const noexcept
+    -> bool
+{
+    return record_predecessors_;
+}
+
+auto ProgramOptions::hasLazyCacheBudget() const noexcept
+    -> bool
+{
+    return !!lazy_cache_budget_;
+}
+
+auto ProgramOptions::getLazyCacheBudget() const noexcept
+    -> std::size_t
+{
+    return lazy_cache_budget_.value();
+}
+
+auto ProgramOptions::getCandidateFailureLimit() const noexcept
+    -> std::optional<std::size_t>
+{
+    return candidate_failure_limit_;
+}
+
+auto ProgramOptions::getCandidateRadius() const noexcept
+    -> std::optional<graph::Distance>
+{
+    return candidate_radius_;
+}
+
+auto ProgramOptions::selectInParallel() const noexcept
+    -> bool
+{
+    return parallel_selection_;
+}
+
+auto ProgramOptions::seedFarthestFirst() const noexcept
+    -> bool
+{
+    return farthest_first_;
+}
+
+auto ProgramOptions::getCenterChoice() const noexcept
+    -> CenterChoice
+{
+    return center_choice_;
+}
+
+auto ProgramOptions::getCheckpointInterval() const noexcept
+    -> std::optional<std::size_t>
+{
+    return checkpoint_interval_;
+}
+
+auto ProgramOptions::resume() const noexcept
+    -> bool
+{
+    return resume_;
+}
+
+auto ProgramOptions::hasSelectionsToSave() const noexcept
+    -> bool
+{
+    return !!selections_to_save_;
+}
+
+auto ProgramOptions::getSelectionsToSave() const noexcept
+    -> std::string_view
+{
+    return selections_to_save_.value();
+}
+
+auto ProgramOptions::hasSelectionsToLoad() const noexcept
+    -> bool
+{
+    return !!selections_to_load_;
+}
+
+auto ProgramOptions::getSelectionsToLoad() const noexcept
+    -> std::string_view
+{
+    return selections_to_load_.value();
+}
+
+auto ProgramOptions::hasGeoJsonFile() const noexcept
+    -> bool
+{
+    return !!geojson_file_;
+}
+
+auto ProgramOptions::getGeoJsonFile() const noexcept
+    -> std::string_view
+{
+    return geojson_file_.value();
+}
+
+auto ProgramOptions::geoJsonLines() const noexcept
+    -> bool
+{
+    return geojson_lines_;
+}
+
+auto ProgramOptions::getGeoJsonDecimals() const noexcept
+    -> std::optional<int>
+{
+    return geojson_decimals_;
+}
+
+auto ProgramOptions::getGeoJsonLimit() const noexcept
+    -> std::optional<std::size_t>
+{
+    return geojson_limit_;
+}
+
+auto ProgramOptions::verifyAnswers() const noexcept
+    -> bool
+{
+    return verify_answers_;
+}
+
+auto ProgramOptions::hasSeed() const noexcept
+    -> bool
+{
+    return !!seed_;
+}
+
+auto ProgramOptions::getSeed() const noexcept
+    -> std::uint64_t
+{
+    return seed_.value();
+}
+
 auto ProgramOptions::getPruneDistance() const noexcept
     -> graph::Distance
 {
@@ -56,6 +253,26 @@ auto utils::parseArguments(int argc, char* argv[])
 
     std::string graph_file;
     std::string result_folder;
+    std::string cache_folder;
+    bool compress_distances = false;
+    bool transposed_copy = false;
+    std::size_t lazy_cache_megabytes = 0;
+    bool record_predecessors = false;
+    std::size_t candidate_failure_limit = 0;
+    graph::Distance candidate_radius = 0;
+    std::uint64_t seed = 0;
+    bool parallel_selection = false;
+    bool farthest_first = false;
+    std::string center_choice = "middle";
+    std::size_t checkpoint_interval = 0;
+    bool resume = false;
+    std::string selections_to_save;
+    std::string selections_to_load;
+    std::string geojson_file;
+    bool geojson_lines = false;
+    int geojson_decimals = 0;
+    std::size_t geojson_limit = 0;
+    bool verify_answers = false;
     graph::Distance prune_distance = 0;
     std::size_t maximum_selections = std::numeric_limits<std::size_t>::max();
 
@@ -80,6 +297,118 @@ auto utils::parseArguments(int argc, char* argv[])
                    "maximum number of selections per node")
         ->check(CLI::PositiveNumber);
 
+    auto* cache_option = app.add_option("-c,--cache",
+                                        cache_folder,
+                                        "folder in which precomputed distance matrices are stored and reused")
+                             ->check(CLI::ExistingDirectory);
+
+    auto* transpose_option = app.add_flag("-t,--transpose",
+                                          transposed_copy,
+                                          "keep a transposed copy of the distance matrix for faster column reads");
+
+    auto* predecessors_option = app.add_flag("-r,--predecessors",
+                                             record_predecessors,
+                                             "store the predecessor of every shortest path next to the distances");
+
+    //the compressed and the lazy oracle support neither a cache, a transposed copy nor predecessors
+    auto* lazy_option = app.add_option("-l,--lazy",
+                                       lazy_cache_megabytes,
+                                       "compute distance rows on demand and cache at most this many MiB of them")
+                            ->check(CLI::PositiveNumber)
+                            ->excludes(cache_option)
+                            ->excludes(transpose_option)
+                            ->excludes(predecessors_option);
+
+    app.add_flag("-z,--compress",
+                 compress_distances,
+                 "keep the distance matrix compressed in memory, slower but much smaller")
+        ->excludes(cache_option)
+        ->excludes(transpose_option)
+        ->excludes(predecessors_option)
+        ->excludes(lazy_option);
+
+    app.add_option("-f,--max-failures",
+                   candidate_failure_limit,
+                   "stop growing a selection after this many rejected candidates in a row")
+        ->check(CLI::PositiveNumber);
+
+    app.add_option("--radius",
+                   candidate_radius,
+                   "only grow a selection with candidates at most this far from its center")
+        ->check(CLI::PositiveNumber);
+
+    auto* seed_option = app.add_option("-s,--seed",
+                                       seed,
+                                       "seed of the random seed pairs, runs with the same seed choose the same pairs");
+
+    app.add_flag("-j,--parallel",
+                 parallel_selection,
+                 "grow the selections of several seed pairs in parallel");
+
+    app.add_flag("-F,--farthest-first",
+                 farthest_first,
+                 "start every selection at the uncovered pair with the largest distance");
+
+    const std::map<std::string, utils::CenterChoice> center_choices{
+        {"middle", utils::CenterChoice::MIDDLE},
+        {"oracle", utils::CenterChoice::ORACLE},
+        {"closeness", utils::CenterChoice::CLOSENESS},
+        {"sampled-closeness", utils::CenterChoice::SAMPLED_CLOSENESS},
+        {"sampled-harmonic", utils::CenterChoice::SAMPLED_HARMONIC},
+        {"betweenness", utils::CenterChoice::BETWEENNESS}};
+
+    app.add_option("--centers",
+                   center_choice,
+                   "choose the middle of a dijkstra path as center, walk the path back through the distance oracle or take the most central node on it")
+        ->check(CLI::IsMember({"middle", "oracle", "closeness", "sampled-closeness", "sampled-harmonic", "betweenness"}));
+
+    auto* checkpoint_option = app.add_option("--checkpoint",
+                                             checkpoint_interval,
+                                             "write a checkpoint of the selection calculation every this many seconds")
+                                  ->check(CLI::PositiveNumber);
+
+    auto* resume_option = app.add_flag("--resume",
+                                       resume,
+                                       "continue the selection calculation from the last checkpoint");
+
+    auto* save_option = app.add_option("--save-selections",
+                                       selections_to_save,
+                                       "write the calculated selections into this file");
+
+    //loaded selections are not calculated, none of the calculation options apply
+    app.add_option("--load-selections",
+                   selections_to_load,
+                   "read the selections from this file instead of calculating them")
+        ->check(CLI::ExistingFile)
+        ->excludes(save_option)
+        ->excludes(checkpoint_option)
+        ->excludes(resume_option);
+
+    auto* geojson_option = app.add_option("--geojson",
+                                          geojson_file,
+                                          "export the selections into this GeoJSON file for viewers");
+
+    app.add_flag("--geojson-lines",
+                 geojson_lines,
+                 "export one GeoJSON feature per line instead of a single FeatureCollection")
+        ->needs(geojson_option);
+
+    auto* decimals_option = app.add_option("--geojson-decimals",
+                                           geojson_decimals,
+                                           "round the exported coordinates to this many decimals")
+                                ->check(CLI::Range(0, 15))
+                                ->needs(geojson_option);
+
+    app.add_option("--geojson-limit",
+                   geojson_limit,
+                   "only export this many of the heaviest selections")
+        ->check(CLI::PositiveNumber)
+        ->needs(geojson_option);
+
+    app.add_flag("--verify",
+                 verify_answers,
+                 "check every answered query against dijkstra and print the number of wrong answers as last column");
+
     try {
         app.parse(argc, argv);
     } catch(const CLI::ParseError& e) {
@@ -91,5 +420,47 @@ auto utils::parseArguments(int argc, char* argv[])
                           maximum_selections,
                           result_folder.empty()
                               ? std::optional<std::string>()
-                              : std::optional{result_folder}};
+                              : std::optional{result_folder},
+                          cache_folder.empty()
+                              ? std::optional<std::string>()
+                              : std::optional{cache_folder},
+                          compress_distances,
+                          transposed_copy,
+                          lazy_cache_megabytes == 0
+                              ? std::optional<std::size_t>()
+                              : std::optional{lazy_cache_megabytes * 1024 * 1024},
+                          record_predecessors,
+                          candidate_failure_limit == 0
+                              ? std::optional<std::size_t>()
+                              : std::optional{candidate_failure_limit},
+                          candidate_radius == 0
+                              ? std::optional<graph::Distance>()
+                              : std::optional{candidate_radius},
+                          seed_option->count() == 0
+                              ? std::optional<std::uint64_t>()
+                              : std::optional{seed},
+                          parallel_selection,
+                          farthest_first,
+                          center_choices.at(center_choice),
+                          checkpoint_interval == 0
+                              ? std::optional<std::size_t>()
+                              : std::optional{checkpoint_interval},
+                          resume,
+                          selections_to_save.empty()
+                              ? std::optional<std::string>()
+                              : std::optional{selections_to_save},
+                          selections_to_load.empty()
+                              ? std::optional<std::string>()
+                              : std::optional{selections_to_load},
+                          geojson_file.empty()
+                              ? std::optional<std::string>()
+                              : std::optional{geojson_file},
+                          geojson_lines,
+                          decimals_option->count() == 0
+                              ? std::optional<int>()
+                              : std::optional{geojson_decimals},
+                          geojson_limit == 0
+                              ? std::optional<std::size_t>()
+                              : std::optional{geojson_limit},
+                          verify_answers};
 }
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <graph/Graph.hpp>
+#include <pathfinding/OneToAllDijkstra.hpp>
+#include <random>
+#include <vector>
+
+namespace test {
+
+// rows x columns grid with edges in both directions between neighbours, the
+// weights are drawn with the seed. One more node without edges is added last,
+// such that every graph has unreachable pairs as well
+inline auto gridGraph(std::size_t rows,
+                      std::size_t columns,
+                      std::uint64_t seed = 42,
+                      graph::Distance max_weight = 100)
+    -> graph::Graph
+{
+    std::mt19937_64 random{seed};
+    std::uniform_int_distribution<graph::Distance> weight{1, max_weight};
+
+    const auto number_of_nodes = rows * columns + 1;
+    std::vector<std::vector<std::pair<graph::Node, graph::Distance>>> adj_list(number_of_nodes);
+    std::vector<double> lats(number_of_nodes);
+    std::vector<double> lngs(number_of_nodes);
+
+    const auto connect = [&](graph::Node from, graph::Node to) {
+        adj_list[from].emplace_back(to, weight(random));
+        adj_list[to].emplace_back(from, weight(random));
+    };
+
+    for(std::size_t row = 0; row < rows; row++) {
+        for(std::size_t column = 0; column < columns; column++) {
+            const auto node = row * columns + column;
+            lats[node] = 48.0 + row * 0.01;
+            lngs[node] = 9.0 + column * 0.01;
+
+            if(column + 1 < columns) {
+                connect(node, node + 1);
+            }
+            if(row + 1 < rows) {
+                connect(node, node + columns);
+            }
+        }
+    }
+
+    return graph::Graph{adj_list, std::move(lats), std::move(lngs)};
+}
+
+// the zero weight edges 4 -> 3 -> 2 <-> 1 behind the only edge 0 -> 4, such
+// that every node after 4 has a backward neighbour at the same distance which
+// is not closer to 0 and the cycle 1 <-> 2 can be walked forever
+inline auto zeroWeightCycleGraph()
+    -> graph::Graph
+{
+    return graph::Graph{{{{4, 5}},
+                         {{2, 0}},
+                         {{1, 0}},
+                         {{2, 0}},
+                         {{3, 0}}},
+                        {48.0, 48.0, 48.0, 48.0, 48.0},
+                        {9.0, 9.01, 9.02, 9.03, 9.04}};
+}
+
+// the exact distances between all pairs of nodes, one row per source
+inline auto allDistances(const graph::Graph& graph)
+    -> std::vector<std::vector<graph::Distance>>
+{
+    pathfinding::OneToAllDijkstra dijkstra{graph};
+    std::vector<std::vector<graph::Distance>> distances;
+
+    for(graph::Node source = 0; source < graph.size(); source++) {
+        distances.emplace_back(dijkstra.computeDistancesFrom(source));
+    }
+
+    return distances;
+}
+
+} // namespace test
@@ -0,0 +1,17 @@
+#include "../TestGraphs.hpp"
+#include <graph/Graph.hpp>
+#include <gtest/gtest.h>
+
+TEST(GraphTest, FingerprintIsStableForTheSameGraph)
+{
+    EXPECT_EQ(test::gridGraph(5, 5, 1).fingerprint(),
+              test::gridGraph(5, 5, 1).fingerprint());
+}
+
+TEST(GraphTest, FingerprintChangesWithTheEdges)
+{
+    const auto graph = test::gridGraph(5, 5, 1);
+
+    EXPECT_NE(graph.fingerprint(), test::gridGraph(5, 5, 2).fingerprint());
+    EXPECT_NE(graph.fingerprint(), test::gridGraph(5, 6, 1).fingerprint());
+}
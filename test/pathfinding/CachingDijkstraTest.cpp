@@ -0,0 +1,82 @@
+#include "../TestGraphs.hpp"
+#include <gtest/gtest.h>
+#include <pathfinding/CachingDijkstra.hpp>
+#include <set>
+
+using pathfinding::CachingDijkstra;
+
+namespace {
+
+auto edgeWeight(const graph::Graph& graph, graph::Node from, graph::Node to)
+    -> std::optional<graph::Distance>
+{
+    std::optional<graph::Distance> weight;
+    for(auto [neig, distance] : graph.getForwardNeigboursOf(from)) {
+        if(neig == to and (!weight or distance < weight.value())) {
+            weight = distance;
+        }
+    }
+    return weight;
+}
+
+// every route has to follow the edges of the graph from the source to the
+// target without visiting a node twice and be as long as the distance
+auto expectShortestRoutes(const graph::Graph& graph, const CachingDijkstra& dijkstra)
+    -> void
+{
+    const auto distances = test::allDistances(graph);
+
+    for(graph::Node source = 0; source < graph.size(); source++) {
+        for(graph::Node target = 0; target < graph.size(); target++) {
+            const auto route = dijkstra.findRoute(source, target);
+
+            if(distances[source][target] == graph::UNREACHABLE) {
+                EXPECT_FALSE(route);
+                continue;
+            }
+
+            ASSERT_TRUE(route) << "from " << source << " to " << target;
+            const auto& nodes = route->getNodes();
+            ASSERT_EQ(nodes.front(), source);
+            ASSERT_EQ(nodes.back(), target);
+            ASSERT_EQ(std::set<graph::Node>(std::begin(nodes), std::end(nodes)).size(), nodes.size());
+
+            graph::Distance length = 0;
+            for(std::size_t i = 1; i < nodes.size(); i++) {
+                const auto weight = edgeWeight(graph, nodes[i - 1], nodes[i]);
+                ASSERT_TRUE(weight) << "no edge from " << nodes[i - 1] << " to " << nodes[i];
+                length += weight.value();
+            }
+            EXPECT_EQ(length, distances[source][target]);
+        }
+    }
+}
+
+} // namespace
+
+TEST(CachingDijkstraTest, WalksRoutesOverZeroWeightCycles)
+{
+    const auto graph = test::zeroWeightCycleGraph();
+    const CachingDijkstra dijkstra{graph};
+
+    expectShortestRoutes(graph, dijkstra);
+}
+
+TEST(CachingDijkstraTest, FollowsRecordedPredecessorsOverZeroWeightCycles)
+{
+    const auto graph = test::zeroWeightCycleGraph();
+    const CachingDijkstra dijkstra{graph, std::nullopt, false, true};
+
+    ASSERT_TRUE(dijkstra.hasPredecessors());
+    expectShortestRoutes(graph, dijkstra);
+}
+
+TEST(CachingDijkstraTest, WalksRoutesThroughGrids)
+{
+    const auto graph = test::gridGraph(6, 5);
+    const CachingDijkstra walking{graph};
+    const CachingDijkstra recorded{graph, std::nullopt, true, true};
+
+    expectShortestRoutes(graph, walking);
+    expectShortestRoutes(graph, recorded);
+}
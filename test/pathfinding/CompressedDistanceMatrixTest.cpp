@@ -0,0 +1,40 @@
+#include "../TestGraphs.hpp"
+#include <gtest/gtest.h>
+#include <pathfinding/CompressedDistanceMatrix.hpp>
+
+using pathfinding::CompressedDistanceMatrix;
+
+namespace {
+
+auto expectLossless(const graph::Graph& graph)
+    -> void
+{
+    const auto distances = test::allDistances(graph);
+    const CompressedDistanceMatrix matrix{graph};
+
+    ASSERT_EQ(matrix.size(), graph.size());
+    for(graph::Node source = 0; source < graph.size(); source++) {
+        for(graph::Node target = 0; target < graph.size(); target++) {
+            ASSERT_EQ(matrix.get(source, target), distances[source][target])
+                << "from " << source << " to " << target;
+        }
+    }
+}
+
+} // namespace
+
+// more nodes than a block and a landmark cover, the last block is partial
+TEST(CompressedDistanceMatrixTest, DecodesEveryDistance)
+{
+    expectLossless(test::gridGraph(13, 11));
+}
+
+TEST(CompressedDistanceMatrixTest, DecodesWideDistances)
+{
+    expectLossless(test::gridGraph(9, 9, 7, graph::Distance{1} << 40));
+}
+
+TEST(CompressedDistanceMatrixTest, DecodesSmallGraphs)
+{
+    expectLossless(test::gridGraph(1, 2));
+}
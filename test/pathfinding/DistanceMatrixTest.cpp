@@ -0,0 +1,107 @@
+#include "../TestGraphs.hpp"
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <pathfinding/DistanceMatrix.hpp>
+
+using pathfinding::DistanceMatrix;
+namespace fs = std::filesystem;
+
+namespace {
+
+auto matrixOf(const std::vector<std::vector<graph::Distance>>& distances)
+    -> DistanceMatrix
+{
+    DistanceMatrix matrix{distances.size()};
+    for(graph::Node source = 0; source < distances.size(); source++) {
+        matrix.setRow(source, distances[source]);
+    }
+    return matrix;
+}
+
+} // namespace
+
+TEST(DistanceMatrixTest, ReturnsTheRowsWhichWereSet)
+{
+    const auto graph = test::gridGraph(6, 7);
+    const auto distances = test::allDistances(graph);
+    const auto matrix = matrixOf(distances);
+
+    ASSERT_EQ(matrix.size(), graph.size());
+    for(graph::Node source = 0; source < graph.size(); source++) {
+        for(graph::Node target = 0; target < graph.size(); target++) {
+            EXPECT_EQ(matrix.get(source, target), distances[source][target]);
+        }
+    }
+}
+
+TEST(DistanceMatrixTest, KeepsUnreachableEntries)
+{
+    const auto graph = test::gridGraph(3, 3);
+    const auto matrix = matrixOf(test::allDistances(graph));
+    const auto isolated = static_cast<graph::Node>(graph.size() - 1);
+
+    EXPECT_EQ(matrix.get(0, isolated), graph::UNREACHABLE);
+    EXPECT_EQ(matrix.get(isolated, 0), graph::UNREACHABLE);
+    EXPECT_EQ(matrix.get(isolated, isolated), 0);
+}
+
+TEST(DistanceMatrixTest, ColumnsMatchTheEntries)
+{
+    const auto graph = test::gridGraph(5, 5);
+    const auto matrix = matrixOf(test::allDistances(graph));
+
+    for(graph::Node target = 0; target < graph.size(); target++) {
+        const auto column = matrix.column(target);
+        for(graph::Node source = 0; source < graph.size(); source++) {
+            EXPECT_EQ(column[source], matrix.get(source, target));
+        }
+    }
+}
+
+TEST(DistanceMatrixTest, CanHoldTheDistancesOfSmallGraphs)
+{
+    EXPECT_TRUE(DistanceMatrix::canHoldDistancesOf(test::gridGraph(10, 10)));
+}
+
+TEST(DistanceMatrixTest, RejectsGraphsWithTooLongPaths)
+{
+    const auto heavy = DistanceMatrix::MAX_DISTANCE / 2 + 1;
+    const graph::Graph graph{{{{1, heavy}}, {{2, heavy}}, {}},
+                             {48.0, 48.0, 48.0},
+                             {9.0, 9.01, 9.02}};
+
+    EXPECT_FALSE(DistanceMatrix::canHoldDistancesOf(graph));
+}
+
+TEST(DistanceMatrixTest, IsReadBackFromItsFile)
+{
+    const auto graph = test::gridGraph(6, 6);
+    const auto matrix = matrixOf(test::allDistances(graph));
+    const auto path = (fs::temp_directory_path() / "DistanceMatrixTest.distances").string();
+
+    ASSERT_TRUE(matrix.toFile(path, graph.fingerprint()));
+    const auto loaded = DistanceMatrix::fromFile(path, graph.fingerprint(), graph.size());
+    fs::remove(path);
+
+    ASSERT_TRUE(loaded);
+    for(graph::Node source = 0; source < graph.size(); source++) {
+        for(graph::Node target = 0; target < graph.size(); target++) {
+            EXPECT_EQ(loaded->get(source, target), matrix.get(source, target));
+        }
+    }
+}
+
+TEST(DistanceMatrixTest, RejectsFilesOfOtherGraphs)
+{
+    const auto graph = test::gridGraph(4, 4);
+    const auto matrix = matrixOf(test::allDistances(graph));
+    const auto path = (fs::temp_directory_path() / "DistanceMatrixTest.distances").string();
+
+    ASSERT_TRUE(matrix.toFile(path, graph.fingerprint()));
+    const auto other_fingerprint = DistanceMatrix::fromFile(path, graph.fingerprint() + 1, graph.size());
+    const auto other_size = DistanceMatrix::fromFile(path, graph.fingerprint(), graph.size() + 1);
+    fs::remove(path);
+
+    EXPECT_FALSE(other_fingerprint);
+    EXPECT_FALSE(other_size);
+}
@@ -0,0 +1,114 @@
+#include "../TestGraphs.hpp"
+#include <gtest/gtest.h>
+#include <pathfinding/CachingDijkstra.hpp>
+#include <random>
+#include <selection/AffiliationFilter.hpp>
+
+using pathfinding::CachingDijkstra;
+using selection::AffiliationFilter;
+using selection::Patch;
+
+namespace {
+
+auto isCandidate(graph::Node n)
+    -> bool
+{
+    return n % 5 != 0;
+}
+
+// the check of a single candidate against the whole patch, like it is done
+// without a filter. The distances are given from the source to the target
+// side, the members are on the other side of the center than the candidate
+template<class Distances>
+auto fullCheck(graph::Node candidate,
+               graph::Node center,
+               const Patch& members,
+               Distances&& distance)
+    -> std::optional<graph::Distance>
+{
+    const auto center_distance = distance(candidate, center);
+    if(!isCandidate(candidate) or center_distance == graph::UNREACHABLE) {
+        return std::nullopt;
+    }
+
+    for(auto [member, center_member_distance] : members) {
+        if(distance(candidate, member) != center_distance + center_member_distance) {
+            return std::nullopt;
+        }
+    }
+
+    return center_distance;
+}
+
+// grows a patch around every center node by node and compares the filter with
+// the full check after every node. Half of the patch is given with the reset
+template<bool IsSource>
+auto expectSameAffiliations(const graph::Graph& graph)
+    -> void
+{
+    const auto distances = test::allDistances(graph);
+    const CachingDijkstra oracle{graph, std::nullopt, true};
+    AffiliationFilter<CachingDijkstra, IsSource> filter{oracle, graph.size()};
+    ASSERT_TRUE(filter.isContiguous());
+
+    //sources reach the center and their targets, targets are reached from both
+    const auto distance = [&](graph::Node candidate, graph::Node other) {
+        return IsSource
+            ? distances[candidate][other]
+            : distances[other][candidate];
+    };
+
+    std::mt19937_64 random{42};
+    std::uniform_int_distribution<graph::Node> node{0, static_cast<graph::Node>(graph.size() - 1)};
+
+    //candidates which survive more than one member, such that the test is not trivial
+    std::size_t survivors = 0;
+
+    for(auto round = 0; round < 20; round++) {
+        const auto center = node(random);
+
+        Patch members;
+        for(auto i = 0; i < 6; i++) {
+            const auto member = node(random);
+            const auto center_member_distance = IsSource
+                ? distances[center][member]
+                : distances[member][center];
+            if(center_member_distance != graph::UNREACHABLE) {
+                members.emplace_back(member, center_member_distance);
+            }
+        }
+
+        const auto half = members.size() / 2;
+        Patch current(std::begin(members), std::begin(members) + half);
+        filter.reset(center, current, isCandidate);
+
+        for(auto i = half; i <= members.size(); i++) {
+            for(graph::Node candidate = 0; candidate < graph.size(); candidate++) {
+                const auto affiliation = filter.affiliation(candidate);
+                ASSERT_EQ(affiliation, fullCheck(candidate, center, current, distance))
+                    << "candidate " << candidate << " center " << center;
+                survivors += affiliation and current.size() > 1;
+            }
+
+            if(i < members.size()) {
+                current.emplace_back(members[i]);
+                filter.add(members[i].first, members[i].second);
+            }
+        }
+    }
+
+    EXPECT_GT(survivors, 0);
+}
+
+} // namespace
+
+// the small weights give many nodes which are consistent with the whole patch
+TEST(AffiliationFilterTest, SourcesMatchTheFullCheck)
+{
+    expectSameAffiliations<true>(test::gridGraph(8, 8, 42, 3));
+}
+
+TEST(AffiliationFilterTest, TargetsMatchTheFullCheck)
+{
+    expectSameAffiliations<false>(test::gridGraph(8, 8, 42, 3));
+}
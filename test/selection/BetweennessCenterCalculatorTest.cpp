@@ -0,0 +1,49 @@
+#include "../TestGraphs.hpp"
+#include "ExactCentrality.hpp"
+#include <gtest/gtest.h>
+#include <numeric>
+#include <pathfinding/Dijkstra.hpp>
+#include <selection/BetweennessCenterCalculator.hpp>
+
+using pathfinding::Dijkstra;
+using BetweennessCalculator = selection::BetweennessCenterCalculator<Dijkstra>;
+
+// the small weights give many pairs with more than one shortest path
+TEST(BetweennessCenterCalculatorTest, EqualsTheExactBetweenness)
+{
+    const auto graph = test::gridGraph(6, 6, 42, 3);
+    const BetweennessCalculator calculator{graph};
+    const auto expected = test::exactBetweenness(graph);
+
+    ASSERT_EQ(calculator.getBetweenness().size(), expected.size());
+    for(graph::Node node = 0; node < graph.size(); node++) {
+        EXPECT_NEAR(calculator.getBetweenness()[node], expected[node], 1e-9);
+    }
+}
+
+TEST(BetweennessCenterCalculatorTest, IsExactIfEveryNodeIsSampled)
+{
+    const auto graph = test::gridGraph(5, 6, 42, 3);
+    const BetweennessCalculator exact{graph};
+    const BetweennessCalculator sampled{graph, graph.size()};
+
+    for(graph::Node node = 0; node < graph.size(); node++) {
+        EXPECT_NEAR(sampled.getBetweenness()[node], exact.getBetweenness()[node], 1e-9);
+    }
+}
+
+TEST(BetweennessCenterCalculatorTest, ScalesTheSampledBetweenness)
+{
+    const auto graph = test::gridGraph(8, 8);
+    const BetweennessCalculator exact{graph};
+    const BetweennessCalculator sampled{graph, graph.size() / 2};
+
+    const auto sum = [](const auto& values) {
+        return std::accumulate(std::begin(values), std::end(values), 0.0);
+    };
+
+    //half of the sources scaled by two estimate the total within a factor of two
+    const auto ratio = sum(sampled.getBetweenness()) / sum(exact.getBetweenness());
+    EXPECT_GT(ratio, 0.5);
+    EXPECT_LT(ratio, 2.0);
+}
@@ -0,0 +1,61 @@
+#include "../TestGraphs.hpp"
+#include "ExactCentrality.hpp"
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <pathfinding/CachingDijkstra.hpp>
+#include <pathfinding/Dijkstra.hpp>
+#include <selection/ClosenessCentralityCenterCalculator.hpp>
+
+using pathfinding::CachingDijkstra;
+using pathfinding::Dijkstra;
+using ClosenessCalculator = selection::ClosenessCentralityCenterCalculator<Dijkstra, CachingDijkstra>;
+namespace fs = std::filesystem;
+
+TEST(ClosenessCentralityCenterCalculatorTest, EqualsTheExactCloseness)
+{
+    const auto graph = test::gridGraph(7, 6);
+    const CachingDijkstra oracle{graph};
+    const ClosenessCalculator calculator{graph, oracle};
+    const auto expected = test::exactCloseness(graph);
+
+    ASSERT_EQ(calculator.getCloseness().size(), expected.size());
+    for(graph::Node node = 0; node < graph.size(); node++) {
+        EXPECT_DOUBLE_EQ(calculator.getCloseness()[node], expected[node]);
+    }
+}
+
+TEST(ClosenessCentralityCenterCalculatorTest, ChoosesTheMostCentralNodeOfThePath)
+{
+    const auto graph = test::gridGraph(5, 5);
+    const CachingDijkstra oracle{graph};
+    ClosenessCalculator calculator{graph, oracle};
+    const auto& closeness = calculator.getCloseness();
+    Dijkstra dijkstra{graph};
+
+    for(graph::Node to = 1; to + 1 < graph.size(); to++) {
+        const auto path = dijkstra.findRoute(0, to).value();
+        const auto center = calculator.calculateCenter(0, to);
+
+        ASSERT_TRUE(center);
+        for(auto node : path.getNodes()) {
+            EXPECT_LE(closeness[node], closeness[center.value()]);
+        }
+    }
+}
+
+TEST(ClosenessCentralityCenterCalculatorTest, ReusesTheCachedCloseness)
+{
+    const auto graph = test::gridGraph(5, 4);
+    const CachingDijkstra oracle{graph};
+    const auto cache_folder = fs::temp_directory_path() / "ClosenessCentralityCenterCalculatorTest";
+    fs::create_directories(cache_folder);
+
+    const ClosenessCalculator calculated{graph, oracle, cache_folder.string()};
+    const ClosenessCalculator cached{graph, oracle, cache_folder.string()};
+    const auto cache_files = std::distance(fs::directory_iterator{cache_folder},
+                                           fs::directory_iterator{});
+    fs::remove_all(cache_folder);
+
+    EXPECT_EQ(cache_files, 1);
+    EXPECT_EQ(cached.getCloseness(), calculated.getCloseness());
+}
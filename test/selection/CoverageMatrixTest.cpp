@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <selection/CoverageMatrix.hpp>
+#include <vector>
+
+using selection::CoverageMatrix;
+
+namespace {
+
+// the matrix next to a plain one with a flag per pair, every change is applied
+// to both and all counters are compared with counting the flags
+class CoverageMatrixTest : public ::testing::Test
+{
+protected:
+    // wider than a block of 512 columns and not a multiple of 64
+    static constexpr auto NUMBER_OF_NODES = std::size_t{700};
+
+    auto uncover(graph::Node from, graph::Node to)
+        -> void
+    {
+        matrix_.uncover(from, to);
+        covered_[from][to] = false;
+    }
+
+    auto cover(graph::Node from, graph::Node to)
+        -> void
+    {
+        matrix_.cover(from, to);
+        covered_[from][to] = true;
+    }
+
+    auto expectSameCoverage() const
+        -> void
+    {
+        std::size_t remaining = 0;
+        for(graph::Node from = 0; from < NUMBER_OF_NODES; from++) {
+            std::size_t remaining_in_row = 0;
+            for(graph::Node to = 0; to < NUMBER_OF_NODES; to++) {
+                ASSERT_EQ(matrix_.isCovered(from, to), covered_[from][to]);
+                remaining_in_row += !covered_[from][to];
+            }
+
+            ASSERT_EQ(matrix_.remainingIn(from), remaining_in_row);
+            ASSERT_EQ(matrix_.isDone(from), remaining_in_row == 0);
+            remaining += remaining_in_row;
+        }
+
+        ASSERT_EQ(matrix_.remaining(), remaining);
+        ASSERT_EQ(matrix_.done(), remaining == 0);
+    }
+
+    CoverageMatrix matrix_{NUMBER_OF_NODES};
+    std::vector<std::vector<bool>> covered_ =
+        std::vector<std::vector<bool>>(NUMBER_OF_NODES, std::vector<bool>(NUMBER_OF_NODES, true));
+    std::mt19937_64 random_{42};
+};
+
+} // namespace
+
+TEST_F(CoverageMatrixTest, StartsCovered)
+{
+    expectSameCoverage();
+}
+
+TEST_F(CoverageMatrixTest, CountsSinglePairs)
+{
+    std::uniform_int_distribution<graph::Node> node{0, NUMBER_OF_NODES - 1};
+
+    for(auto i = 0; i < 20000; i++) {
+        uncover(node(random_), node(random_));
+    }
+    expectSameCoverage();
+
+    //covering a pair twice must not count it twice
+    for(auto i = 0; i < 20000; i++) {
+        cover(node(random_), node(random_));
+    }
+    expectSameCoverage();
+}
+
+TEST_F(CoverageMatrixTest, CoversPatchesAndFreesDoneRows)
+{
+    for(graph::Node from = 0; from < NUMBER_OF_NODES; from += 3) {
+        for(graph::Node to = 0; to < NUMBER_OF_NODES; to++) {
+            uncover(from, to);
+        }
+    }
+
+    std::uniform_int_distribution<graph::Node> node{0, NUMBER_OF_NODES - 1};
+    for(auto i = 0; i < 50; i++) {
+        std::vector<std::pair<graph::Node, graph::Distance>> sources;
+        std::vector<std::pair<graph::Node, graph::Distance>> targets;
+        for(auto j = 0; j < 40; j++) {
+            sources.emplace_back(node(random_), 0);
+            targets.emplace_back(node(random_), 0);
+        }
+
+        std::size_t newly_covered = 0;
+        for(auto [from, _] : sources) {
+            for(auto [to, __] : targets) {
+                if(!covered_[from][to]) {
+                    newly_covered++;
+                    covered_[from][to] = true;
+                }
+            }
+        }
+
+        ASSERT_EQ(matrix_.cover(sources, targets), newly_covered);
+    }
+    expectSameCoverage();
+
+    for(graph::Node from = 0; from < NUMBER_OF_NODES; from += 3) {
+        for(graph::Node to = 0; to < NUMBER_OF_NODES; to++) {
+            cover(from, to);
+        }
+    }
+    expectSameCoverage();
+}
+
+TEST_F(CoverageMatrixTest, FindsEveryUncoveredPairInRowMajorOrder)
+{
+    std::uniform_int_distribution<graph::Node> node{0, NUMBER_OF_NODES - 1};
+    for(auto i = 0; i < 5000; i++) {
+        uncover(node(random_), node(random_));
+    }
+    for(auto i = 0; i < 2000; i++) {
+        cover(node(random_), node(random_));
+    }
+
+    std::size_t k = 0;
+    for(graph::Node from = 0; from < NUMBER_OF_NODES; from++) {
+        for(graph::Node to = 0; to < NUMBER_OF_NODES; to++) {
+            if(!covered_[from][to]) {
+                ASSERT_EQ(matrix_.findUncovered(k++), std::pair(from, to));
+            }
+        }
+    }
+
+    ASSERT_EQ(k, matrix_.remaining());
+}
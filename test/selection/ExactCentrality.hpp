@@ -0,0 +1,117 @@
+#pragma once
+
+#include "../TestGraphs.hpp"
+#include <algorithm>
+#include <graph/Graph.hpp>
+#include <numeric>
+#include <vector>
+
+namespace test {
+
+// n divided by the sum of the distances from every node which reaches the
+// node, zero if no other node reaches it
+inline auto exactCloseness(const graph::Graph& graph)
+    -> std::vector<double>
+{
+    const auto distances = allDistances(graph);
+    std::vector<double> closeness;
+
+    for(graph::Node to = 0; to < graph.size(); to++) {
+        graph::Distance farness = 0;
+        for(graph::Node from = 0; from < graph.size(); from++) {
+            if(distances[from][to] != graph::UNREACHABLE) {
+                farness += distances[from][to];
+            }
+        }
+
+        closeness.emplace_back(farness == 0
+                                   ? 0.0
+                                   : static_cast<double>(graph.size()) / farness);
+    }
+
+    return closeness;
+}
+
+// sum of the inverse distances from every other node which reaches the node
+inline auto exactHarmonic(const graph::Graph& graph)
+    -> std::vector<double>
+{
+    const auto distances = allDistances(graph);
+    std::vector<double> harmonic(graph.size(), 0.0);
+
+    for(graph::Node to = 0; to < graph.size(); to++) {
+        for(graph::Node from = 0; from < graph.size(); from++) {
+            const auto distance = distances[from][to];
+            if(distance != graph::UNREACHABLE and distance > 0) {
+                harmonic[to] += 1.0 / distance;
+            }
+        }
+    }
+
+    return harmonic;
+}
+
+// the number of shortest paths from the source to every node, counted in the
+// order of the distances. Needs positive edge weights
+inline auto countShortestPaths(const graph::Graph& graph,
+                               const std::vector<graph::Distance>& from_source)
+    -> std::vector<double>
+{
+    std::vector<graph::Node> order(graph.size());
+    std::iota(std::begin(order), std::end(order), 0);
+    std::sort(std::begin(order),
+              std::end(order),
+              [&](auto lhs, auto rhs) {
+                  return from_source[lhs] < from_source[rhs];
+              });
+
+    std::vector<double> counts(graph.size(), 0.0);
+    for(auto node : order) {
+        if(from_source[node] == 0) {
+            counts[node] = 1.0;
+            continue;
+        }
+
+        for(auto [before, distance] : graph.getBackwardNeigboursOf(node)) {
+            if(from_source[before] != graph::UNREACHABLE
+               and from_source[before] + distance == from_source[node]) {
+                counts[node] += counts[before];
+            }
+        }
+    }
+
+    return counts;
+}
+
+// the fraction of the shortest paths between every ordered pair of other
+// nodes which pass through the node, summed over all pairs
+inline auto exactBetweenness(const graph::Graph& graph)
+    -> std::vector<double>
+{
+    const auto distances = allDistances(graph);
+
+    std::vector<std::vector<double>> counts;
+    for(graph::Node source = 0; source < graph.size(); source++) {
+        counts.emplace_back(countShortestPaths(graph, distances[source]));
+    }
+
+    std::vector<double> betweenness(graph.size(), 0.0);
+    for(graph::Node node = 0; node < graph.size(); node++) {
+        for(graph::Node from = 0; from < graph.size(); from++) {
+            for(graph::Node to = 0; to < graph.size(); to++) {
+                if(from == node or to == node or from == to
+                   or distances[from][node] == graph::UNREACHABLE
+                   or distances[node][to] == graph::UNREACHABLE
+                   or distances[from][node] + distances[node][to] != distances[from][to]) {
+                    continue;
+                }
+
+                betweenness[node] += counts[from][node] * counts[node][to] / counts[from][to];
+            }
+        }
+    }
+
+    return betweenness;
+}
+
+} // namespace test
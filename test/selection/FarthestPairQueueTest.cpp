@@ -0,0 +1,104 @@
+#include "../TestGraphs.hpp"
+#include <gtest/gtest.h>
+#include <pathfinding/CachingDijkstra.hpp>
+#include <random>
+#include <selection/CoverageMatrix.hpp>
+#include <selection/FarthestPairQueue.hpp>
+#include <set>
+#include <tuple>
+
+using pathfinding::CachingDijkstra;
+using selection::CoverageMatrix;
+using selection::FarthestPairQueue;
+
+namespace {
+
+// the uncovered pairs ordered by their distance, next to the coverage matrix
+using PairsByDistance = std::set<std::tuple<graph::Distance, graph::Node, graph::Node>>;
+
+// uncovers every pair of distinct nodes which are connected, like the selection
+// calculator does before it starts
+auto uncoverReachablePairs(const CachingDijkstra& oracle,
+                           std::size_t number_of_nodes,
+                           CoverageMatrix& coverage)
+    -> PairsByDistance
+{
+    PairsByDistance uncovered;
+    for(graph::Node from = 0; from < number_of_nodes; from++) {
+        for(graph::Node to = 0; to < number_of_nodes; to++) {
+            const auto distance = oracle.findDistance(from, to);
+            if(from != to and distance != graph::UNREACHABLE) {
+                coverage.uncover(from, to);
+                uncovered.emplace(distance, from, to);
+            }
+        }
+    }
+    return uncovered;
+}
+
+} // namespace
+
+// more targets per source than the first window holds, such that every
+// source refills its window several times
+TEST(FarthestPairQueueTest, HandsOutEveryPairOnceFarthestFirst)
+{
+    const auto graph = test::gridGraph(15, 15);
+    const CachingDijkstra oracle{graph};
+    CoverageMatrix coverage{graph.size()};
+    auto uncovered = uncoverReachablePairs(oracle, graph.size(), coverage);
+    const auto number_of_pairs = uncovered.size();
+
+    FarthestPairQueue<CachingDijkstra> queue{oracle, coverage, graph.size()};
+
+    auto last_distance = graph::UNREACHABLE;
+    std::size_t popped = 0;
+    while(auto pair = queue.pop()) {
+        const auto [from, to] = pair.value();
+        const auto distance = oracle.findDistance(from, to);
+
+        ASSERT_LE(distance, last_distance);
+        ASSERT_EQ(uncovered.erase({distance, from, to}), 1u) << from << " to " << to << " twice";
+
+        last_distance = distance;
+        popped++;
+    }
+
+    EXPECT_EQ(popped, number_of_pairs);
+}
+
+// the selections cover the popped pair and many others, the next pair
+// has to be the farthest one of the pairs which are left
+TEST(FarthestPairQueueTest, SkipsPairsWhichWereCoveredInBetween)
+{
+    const auto graph = test::gridGraph(12, 12);
+    const CachingDijkstra oracle{graph};
+    CoverageMatrix coverage{graph.size()};
+    auto uncovered = uncoverReachablePairs(oracle, graph.size(), coverage);
+
+    FarthestPairQueue<CachingDijkstra> queue{oracle, coverage, graph.size()};
+
+    std::mt19937_64 random{42};
+    std::uniform_int_distribution<graph::Node> node{0, static_cast<graph::Node>(graph.size() - 1)};
+
+    const auto cover = [&](graph::Node from, graph::Node to) {
+        if(!coverage.isCovered(from, to)) {
+            coverage.cover(from, to);
+            uncovered.erase({oracle.findDistance(from, to), from, to});
+        }
+    };
+
+    while(auto pair = queue.pop()) {
+        const auto [from, to] = pair.value();
+
+        ASSERT_FALSE(coverage.isCovered(from, to));
+        ASSERT_EQ(oracle.findDistance(from, to), std::get<0>(*std::rbegin(uncovered)));
+
+        cover(from, to);
+        for(auto i = 0; i < 5; i++) {
+            cover(node(random), node(random));
+        }
+    }
+
+    EXPECT_TRUE(uncovered.empty());
+    EXPECT_TRUE(coverage.done());
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <random>
+#include <selection/NodeSelection.hpp>
+#include <selection/SelectionStore.hpp>
+
+namespace test {
+
+// selections with patches of random nodes and distances, some of them empty
+inline auto randomSelections(std::size_t number_of_selections,
+                             std::size_t number_of_nodes,
+                             std::uint64_t seed = 42)
+    -> selection::SelectionStore
+{
+    std::mt19937_64 random{seed};
+    std::uniform_int_distribution<graph::Node> node{0, static_cast<graph::Node>(number_of_nodes - 1)};
+    std::uniform_int_distribution<graph::Distance> distance{0, graph::Distance{1} << 40};
+    std::uniform_int_distribution<std::size_t> patch_size{0, 20};
+
+    const auto randomPatch = [&] {
+        selection::Patch patch;
+        for(auto size = patch_size(random); size > 0; size--) {
+            patch.emplace_back(node(random), distance(random));
+        }
+        return patch;
+    };
+
+    selection::SelectionStore selections;
+    for(std::size_t i = 0; i < number_of_selections; i++) {
+        const auto sources = randomPatch();
+        const auto targets = randomPatch();
+        selections.add(sources, targets, node(random), random() % 2 == 0);
+    }
+
+    return selections;
+}
+
+template<class Patch, class OtherPatch>
+auto expectSamePatch(const Patch& patch, const OtherPatch& other)
+    -> void
+{
+    ASSERT_EQ(patch.size(), other.size());
+    for(std::size_t i = 0; i < patch.size(); i++) {
+        EXPECT_EQ(patch[i], other[i]);
+    }
+}
+
+template<class Selection, class OtherSelection>
+auto expectSameSelection(const Selection& selection, const OtherSelection& other)
+    -> void
+{
+    expectSamePatch(selection.getSourcePatch(), other.getSourcePatch());
+    expectSamePatch(selection.getTargetPatch(), other.getTargetPatch());
+    EXPECT_EQ(selection.getCenter(), other.getCenter());
+    EXPECT_EQ(selection.isInverseValid(), other.isInverseValid());
+}
+
+} // namespace test
@@ -0,0 +1,53 @@
+#include "../TestGraphs.hpp"
+#include "ExactCentrality.hpp"
+#include <gtest/gtest.h>
+#include <pathfinding/Dijkstra.hpp>
+#include <selection/SampledCentralityCenterCalculator.hpp>
+
+using pathfinding::Dijkstra;
+using selection::Centrality;
+using SampledCalculator = selection::SampledCentralityCenterCalculator<Dijkstra>;
+
+namespace {
+
+// log(n) / epsilon^2 is far more than the nodes of the test graphs
+constexpr auto ALL_NODES_EPSILON = 0.01;
+
+} // namespace
+
+TEST(SampledCentralityCenterCalculatorTest, ClosenessIsExactIfEveryNodeIsSampled)
+{
+    const auto graph = test::gridGraph(7, 6);
+    const SampledCalculator calculator{graph, Centrality::CLOSENESS, ALL_NODES_EPSILON};
+    const auto expected = test::exactCloseness(graph);
+
+    ASSERT_EQ(calculator.getCentrality().size(), expected.size());
+    for(graph::Node node = 0; node < graph.size(); node++) {
+        EXPECT_DOUBLE_EQ(calculator.getCentrality()[node], expected[node]);
+    }
+}
+
+TEST(SampledCentralityCenterCalculatorTest, HarmonicIsExactIfEveryNodeIsSampled)
+{
+    const auto graph = test::gridGraph(7, 6);
+    const SampledCalculator calculator{graph, Centrality::HARMONIC, ALL_NODES_EPSILON};
+    const auto expected = test::exactHarmonic(graph);
+
+    ASSERT_EQ(calculator.getCentrality().size(), expected.size());
+    for(graph::Node node = 0; node < graph.size(); node++) {
+        EXPECT_NEAR(calculator.getCentrality()[node], expected[node], 1e-9);
+    }
+}
+
+TEST(SampledCentralityCenterCalculatorTest, SamplesTheSameSourcesForTheSameSeed)
+{
+    const auto graph = test::gridGraph(10, 10);
+    const SampledCalculator first{graph, Centrality::HARMONIC, 1.0, 3};
+    const SampledCalculator second{graph, Centrality::HARMONIC, 1.0, 3};
+    const SampledCalculator other{graph, Centrality::HARMONIC, 1.0, 4};
+
+    for(graph::Node node = 0; node < graph.size(); node++) {
+        EXPECT_NEAR(first.getCentrality()[node], second.getCentrality()[node], 1e-9);
+    }
+    EXPECT_NE(first.getCentrality(), other.getCentrality());
+}
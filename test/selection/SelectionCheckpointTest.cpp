@@ -0,0 +1,107 @@
+#include "RandomSelections.hpp"
+#include <filesystem>
+#include <fmt/core.h>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <selection/SelectionCheckpoint.hpp>
+#include <utils/Range.hpp>
+
+using selection::CheckpointWriter;
+using selection::loadCheckpoint;
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr auto NUMBER_OF_NODES = std::size_t{300};
+constexpr auto FINGERPRINT = std::uint64_t{0x1234};
+constexpr auto PRUNE_DISTANCE = graph::Distance{10};
+
+class SelectionCheckpointTest : public ::testing::Test
+{
+protected:
+    ~SelectionCheckpointTest() override
+    {
+        fs::remove(path_);
+    }
+
+    // the writer waits for its last checkpoint before it is destroyed
+    auto writeCheckpoints(std::size_t number_of_checkpoints)
+        -> void
+    {
+        CheckpointWriter writer{path_, FINGERPRINT, NUMBER_OF_NODES, PRUNE_DISTANCE};
+
+        for(auto checkpoint : utils::range(number_of_checkpoints)) {
+            for(auto i : utils::range(checkpoint * 10, checkpoint * 10 + 10)) {
+                writer.addSelection(selections_[i]);
+                writer.addCoveredPair(i, i + 1);
+            }
+            writer.takeCheckpoint(fmt::format("state {}", checkpoint));
+        }
+    }
+
+    auto expectCheckpoint(std::size_t number_of_checkpoints)
+        -> void
+    {
+        const auto checkpoint = loadCheckpoint(path_, FINGERPRINT, NUMBER_OF_NODES, PRUNE_DISTANCE);
+        ASSERT_TRUE(checkpoint);
+
+        EXPECT_EQ(checkpoint->random_state, fmt::format("state {}", number_of_checkpoints - 1));
+
+        ASSERT_EQ(checkpoint->selections.size(), number_of_checkpoints * 10);
+        ASSERT_EQ(checkpoint->covered_pairs.size(), number_of_checkpoints * 10);
+        for(auto i : utils::range(number_of_checkpoints * 10)) {
+            test::expectSameSelection(checkpoint->selections[i], selections_[i]);
+            EXPECT_EQ(checkpoint->covered_pairs[i], std::pair(graph::Node(i), graph::Node(i + 1)));
+        }
+    }
+
+    const std::string path_ = (fs::temp_directory_path() / "SelectionCheckpointTest.checkpoint").string();
+    const selection::SelectionStore selections_ = test::randomSelections(100, NUMBER_OF_NODES);
+};
+
+} // namespace
+
+TEST_F(SelectionCheckpointTest, RestoresTheSelectionsAndPairs)
+{
+    writeCheckpoints(1);
+    expectCheckpoint(1);
+}
+
+// the records of the earlier checkpoints are copied from the previous file
+TEST_F(SelectionCheckpointTest, KeepsTheRecordsOfEarlierCheckpoints)
+{
+    writeCheckpoints(7);
+    expectCheckpoint(7);
+}
+
+TEST_F(SelectionCheckpointTest, RejectsCheckpointsOfOtherRuns)
+{
+    writeCheckpoints(2);
+
+    EXPECT_FALSE(loadCheckpoint(path_, FINGERPRINT + 1, NUMBER_OF_NODES, PRUNE_DISTANCE));
+    EXPECT_FALSE(loadCheckpoint(path_, FINGERPRINT, NUMBER_OF_NODES + 1, PRUNE_DISTANCE));
+    EXPECT_FALSE(loadCheckpoint(path_, FINGERPRINT, NUMBER_OF_NODES, PRUNE_DISTANCE + 1));
+    EXPECT_FALSE(loadCheckpoint(path_ + ".missing", FINGERPRINT, NUMBER_OF_NODES, PRUNE_DISTANCE));
+}
+
+TEST_F(SelectionCheckpointTest, RejectsTruncatedCheckpoints)
+{
+    writeCheckpoints(2);
+    fs::resize_file(path_, fs::file_size(path_) - 1);
+
+    EXPECT_FALSE(loadCheckpoint(path_, FINGERPRINT, NUMBER_OF_NODES, PRUNE_DISTANCE));
+}
+
+// the last record is a covered pair, its second node is the last word of the file
+TEST_F(SelectionCheckpointTest, RejectsNodesOutsideOfTheGraph)
+{
+    writeCheckpoints(1);
+
+    const std::uint32_t invalid_node = NUMBER_OF_NODES;
+    std::fstream file{path_, std::ios::in | std::ios::out | std::ios::binary};
+    file.seekp(-static_cast<std::streamoff>(sizeof(invalid_node)), std::ios::end);
+    file.write(reinterpret_cast<const char*>(&invalid_node), sizeof(invalid_node));
+    file.close();
+
+    EXPECT_FALSE(loadCheckpoint(path_, FINGERPRINT, NUMBER_OF_NODES, PRUNE_DISTANCE));
+}
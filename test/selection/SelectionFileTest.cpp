@@ -0,0 +1,118 @@
+#include "RandomSelections.hpp"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <selection/SelectionFile.hpp>
+
+using selection::SelectionFile;
+using selection::SelectionFileWriter;
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr auto NUMBER_OF_NODES = std::size_t{300};
+constexpr auto FINGERPRINT = std::uint64_t{0x1234};
+constexpr auto PRUNE_DISTANCE = graph::Distance{10};
+
+class SelectionFileTest : public ::testing::Test
+{
+protected:
+    ~SelectionFileTest() override
+    {
+        fs::remove(path_);
+    }
+
+    auto writeSelections(const selection::SelectionStore& selections)
+        -> void
+    {
+        SelectionFileWriter writer{path_, FINGERPRINT, NUMBER_OF_NODES, PRUNE_DISTANCE};
+        for(std::size_t i = 0; i < selections.size(); i++) {
+            writer.add(selections[i]);
+        }
+        ASSERT_TRUE(writer.finish());
+    }
+
+    auto open() const
+        -> std::optional<SelectionFile>
+    {
+        return SelectionFile::open(path_, FINGERPRINT, NUMBER_OF_NODES, PRUNE_DISTANCE);
+    }
+
+    const std::string path_ = (fs::temp_directory_path() / "SelectionFileTest.selections").string();
+};
+
+} // namespace
+
+TEST_F(SelectionFileTest, MapsTheWrittenSelections)
+{
+    const auto selections = test::randomSelections(200, NUMBER_OF_NODES);
+    writeSelections(selections);
+
+    const auto file = open();
+    ASSERT_TRUE(file);
+    ASSERT_EQ(file->size(), selections.size());
+    for(std::size_t i = 0; i < selections.size(); i++) {
+        test::expectSameSelection((*file)[i], selections[i]);
+    }
+}
+
+TEST_F(SelectionFileTest, MapsFilesWithoutSelections)
+{
+    writeSelections(selection::SelectionStore{});
+
+    const auto file = open();
+    ASSERT_TRUE(file);
+    EXPECT_TRUE(file->empty());
+}
+
+TEST_F(SelectionFileTest, RemovesUnfinishedFiles)
+{
+    const auto selections = test::randomSelections(10, NUMBER_OF_NODES);
+    {
+        SelectionFileWriter writer{path_, FINGERPRINT, NUMBER_OF_NODES, PRUNE_DISTANCE};
+        writer.add(selections[0]);
+    }
+
+    EXPECT_FALSE(fs::exists(path_));
+    EXPECT_FALSE(open());
+}
+
+TEST_F(SelectionFileTest, RejectsFilesOfOtherRuns)
+{
+    writeSelections(test::randomSelections(10, NUMBER_OF_NODES));
+
+    EXPECT_FALSE(SelectionFile::open(path_, FINGERPRINT + 1, NUMBER_OF_NODES, PRUNE_DISTANCE));
+    EXPECT_FALSE(SelectionFile::open(path_, FINGERPRINT, NUMBER_OF_NODES + 1, PRUNE_DISTANCE));
+    EXPECT_FALSE(SelectionFile::open(path_, FINGERPRINT, NUMBER_OF_NODES, PRUNE_DISTANCE + 1));
+}
+
+TEST_F(SelectionFileTest, RejectsTruncatedFiles)
+{
+    writeSelections(test::randomSelections(10, NUMBER_OF_NODES));
+    fs::resize_file(path_, fs::file_size(path_) - 1);
+
+    EXPECT_FALSE(open());
+}
+
+// the nodes of the first patch follow the header page
+TEST_F(SelectionFileTest, RejectsNodesOutsideOfTheGraph)
+{
+    selection::SelectionStore selections;
+    selections.add(selection::Patch{{7, 1}, {8, 2}}, selection::Patch{{9, 3}}, 7, true);
+    writeSelections(selections);
+
+    constexpr auto FIRST_PATCH_OFFSET = std::streamoff{4096};
+    std::fstream file{path_, std::ios::in | std::ios::out | std::ios::binary};
+
+    std::uint32_t first_node = 0;
+    file.seekg(FIRST_PATCH_OFFSET);
+    file.read(reinterpret_cast<char*>(&first_node), sizeof(first_node));
+    ASSERT_EQ(first_node, 7u);
+
+    const std::uint32_t invalid_node = NUMBER_OF_NODES;
+    file.seekp(FIRST_PATCH_OFFSET);
+    file.write(reinterpret_cast<const char*>(&invalid_node), sizeof(invalid_node));
+    file.close();
+
+    EXPECT_FALSE(open());
+}
@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <utils/FenwickTree.hpp>
+#include <vector>
+
+using utils::FenwickTree;
+
+namespace {
+
+// compares the tree with summing up the counts on every index
+auto expectSamePrefixSums(const FenwickTree& tree, const std::vector<long long>& counts)
+    -> void
+{
+    long long sum = 0;
+    for(std::size_t index = 0; index < counts.size(); index++) {
+        ASSERT_EQ(tree.prefixSum(index), sum);
+
+        for(auto k = sum; k < sum + counts[index]; k++) {
+            ASSERT_EQ(tree.find(k), index);
+        }
+
+        sum += counts[index];
+    }
+
+    ASSERT_EQ(tree.prefixSum(counts.size()), sum);
+}
+
+} // namespace
+
+TEST(FenwickTreeTest, FindsTheIndexOfEveryUnit)
+{
+    std::mt19937_64 random{42};
+    std::uniform_int_distribution<long long> count{0, 5};
+
+    for(auto size : {1ul, 2ul, 7ul, 64ul, 100ul}) {
+        FenwickTree tree{size};
+        std::vector<long long> counts(size, 0);
+
+        for(auto round = 0; round < 3; round++) {
+            for(std::size_t index = 0; index < size; index++) {
+                const auto delta = count(random) - counts[index] / 2;
+                tree.add(index, delta);
+                counts[index] += delta;
+            }
+
+            expectSamePrefixSums(tree, counts);
+        }
+    }
+}